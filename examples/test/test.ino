@@ -31,6 +31,7 @@ const String COMMAND_TEST = "test";
 const String COMMAND_HELLO = "hello";
 const String COMMAND_POINTER = "pointer";
 const String COMMAND_LED = "led";
+const String COMMAND_TABLE = "table";
 
 void setup()
 {
@@ -48,6 +49,7 @@ void setup()
     commander.addCommand( COMMAND_HELLO, cmdHello );
     commander.addCommand( COMMAND_POINTER, cmdPointer );
     commander.addCommand( COMMAND_LED, cmdLed );
+    commander.addCommand( COMMAND_TABLE, cmdTable );
     commander.setDefaultCallback( cmdDefault );
 }
 
@@ -86,6 +88,22 @@ void cmdLed( String arguments, StreamCommander * instance )
     }
 }
 
+void cmdTable( String arguments, StreamCommander * instance )
+{
+    // Stream the response piece by piece, instead of building it as a whole String first
+    Print & response = instance->beginResponse();
+
+    for ( int i = 0; i < 16; i++ )
+    {
+        response.print( i );
+        response.print( '=' );
+        response.print( i * i );
+        response.print( ' ' );
+    }
+
+    instance->endMessage();
+}
+
 void cmdDefault( String command, String arguments, StreamCommander * instance )
 {
     instance->sendResponse( "Command '" + command + "' with arguments '" + arguments + "' not registered." );
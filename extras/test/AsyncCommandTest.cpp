@@ -0,0 +1,92 @@
+/*
+    Copyright 2019 Jan-Eric Schober
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+// Asynchronous commands: tags, cancellation by the host (including tags which don't fit into an unsigned int), and deadlines.
+
+#include "Test.hpp"
+
+// StreamCommander Library
+#include <StreamCommander.hpp>
+
+// C++ Standard Libraries
+#include <chrono>
+#include <string>
+#include <thread>
+
+// Global, just like in a sketch, so all members start zero-initialized
+MockStream stream;
+StreamCommander commander( &stream );
+
+static int numCalls = 0;
+
+StreamCommander::CommandResult commandSpin( String arguments, StreamCommander * instance )
+{
+    numCalls++;
+
+    return instance->isCancelled() ? StreamCommander::DONE : StreamCommander::PENDING;
+}
+
+// Feeds the given line, executes it, and returns the output.
+static std::string command( const std::string & line )
+{
+    stream.feed( line + "\n" );
+    commander.fetchCommand();
+
+    return stream.takeOutput();
+}
+
+static void testCancel()
+{
+    CHECK( command( "spin" ).find( "pending:1 spin" ) != std::string::npos );
+    CHECK( commander.getNumPendingCommands() == 1 );
+
+    CHECK( command( "cancel x" ).find( "error:Invalid tag 'x'." ) != std::string::npos );
+    CHECK( command( "cancel 2" ).find( "error:No pending request with tag '2'." ) != std::string::npos );
+
+    // 2^32 + 1 must not be narrowed onto tag 1 (just like 65537 on 16 bit ints); neither must numbers beyond any integer type
+    std::string wrapping = std::to_string( ( 1ULL << ( 8 * sizeof( unsigned int ) ) ) + 1 );
+
+    CHECK( command( "cancel " + wrapping ).find( "error:No pending request with tag '" + wrapping + "'." ) != std::string::npos );
+    CHECK( command( "cancel 99999999999999999999999" ).find( "error:No pending request" ) != std::string::npos );
+    CHECK( commander.getNumPendingCommands() == 1 );
+
+    CHECK( command( "cancel 1" ).find( "cancelled:1" ) != std::string::npos );
+    CHECK( commander.getNumPendingCommands() == 0 );
+}
+
+static void testDeadline()
+{
+    CHECK( command( "spin2" ).find( "pending:2 spin2" ) != std::string::npos );
+
+    std::this_thread::sleep_for( std::chrono::milliseconds( 50 ) );
+    commander.fetchCommand();
+
+    CHECK( commander.getNumPendingCommands() == 0 );
+    CHECK( stream.takeOutput().find( "error:" ) != std::string::npos );
+}
+
+int main()
+{
+    commander.init();
+    commander.addAsyncCommand( "spin", commandSpin );
+    commander.addAsyncCommand( "spin2", commandSpin, 20 );
+    stream.takeOutput();
+
+    testCancel();
+    testDeadline();
+
+    return EXIT_SUCCESS;
+}
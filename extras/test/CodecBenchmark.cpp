@@ -0,0 +1,188 @@
+/*
+    Copyright 2019 Jan-Eric Schober
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+// Head-to-head benchmark of the built-in codecs: receives and executes the same commands, and sends the same messages, in every codec.
+// Reports the bytes on the wire and the time per command/message. Received bytes are handed over by a span transport, and sent ones are only counted,
+// so the stream itself doesn't dominate the results. Only the counts get checked, since timings depend on the host.
+
+#include "Test.hpp"
+
+// StreamCommander Library
+#include <StreamCommander.hpp>
+
+// C++ Standard Libraries
+#include <chrono>
+#include <string>
+
+static const int NUM_COMMANDS = 20000;
+static const int NUM_MESSAGES = 20000;
+static const int BATCH_LENGTH = 8; // StreamCommander::COMMAND_QUEUE_SIZE
+static const char ARGUMENTS[] = "12345";
+
+// Stream which only counts the bytes written to it.
+class CountingStream : public Stream
+{
+public:
+    unsigned long numWritten = 0;
+
+    int available() override { return 0; }
+    int read() override { return -1; }
+    int peek() override { return -1; }
+
+    size_t write( uint8_t character ) override
+    {
+        numWritten++;
+
+        return 1;
+    }
+
+    size_t write( const uint8_t * data, size_t length ) override
+    {
+        numWritten += length;
+
+        return length;
+    }
+};
+
+// Span transport, which hands over a prepared buffer up to the released end, just like a host which waits for its' commands to be executed.
+class BufferTransport : public SpanTransport
+{
+public:
+    std::string buffer;
+    size_t position = 0;
+    size_t end = 0;
+
+    const char * peekSpan( int & length ) override
+    {
+        length = end - position;
+
+        return buffer.data() + position;
+    }
+
+    void consumeSpan( int length ) override
+    {
+        position += length;
+    }
+};
+
+// Global, just like in a sketch, so all members start zero-initialized
+CountingStream stream;
+BufferTransport transport;
+StreamCommander commander( &stream );
+
+TextCodec textCodec;
+BinaryCodec binaryCodec;
+MessagePackCodec messagePackCodec;
+
+static int numExecuted = 0;
+
+void commandNop( String arguments, StreamCommander * instance )
+{
+    numExecuted++;
+}
+
+// Encodes a command in the wire format of the given codec.
+static std::string encodeCommand( Codec * codec, const std::string & name, byte commandId )
+{
+    std::string arguments = ARGUMENTS;
+
+    if ( codec == &binaryCodec )
+    {
+        // The length includes the command ID, and fits into a single varint byte
+        return std::string( 1, (char) ( 1 + arguments.size() ) ) + (char) commandId + arguments;
+    }
+
+    if ( codec == &messagePackCodec )
+    {
+        // [<command ID>, "<arguments>"] as fixarray, positive fixint and fixstr
+        return std::string( 1, (char) 0x92 ) + (char) commandId + (char) ( 0xA0 | arguments.size() ) + arguments;
+    }
+
+    return name + " " + arguments + "\n";
+}
+
+static double elapsedNanoseconds( std::chrono::steady_clock::time_point start, int count )
+{
+    return std::chrono::duration<double, std::nano>( std::chrono::steady_clock::now() - start ).count() / count;
+}
+
+static void benchmark( Codec * codec )
+{
+    byte commandId = commander.getNumCommands() - 1;
+    std::string command = encodeCommand( codec, "nop", commandId );
+
+    commander.setCodec( codec );
+
+    // Receiving: decode, queue and execute every command
+    transport.buffer.clear();
+    transport.position = 0;
+    transport.end = 0;
+
+    for ( int i = 0; i < NUM_COMMANDS; i++ )
+    {
+        transport.buffer += command;
+    }
+
+    numExecuted = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    // Release a batch of commands which fits into the command queue, as soon as the previous one has been executed
+    while ( transport.position < transport.buffer.size() || commander.getNumQueuedCommands() > 0 )
+    {
+        if ( transport.position == transport.end && commander.getNumQueuedCommands() == 0 )
+        {
+            transport.end = min( transport.end + BATCH_LENGTH * command.size(), transport.buffer.size() );
+        }
+
+        commander.fetchCommand();
+    }
+
+    double receiveTime = elapsedNanoseconds( start, NUM_COMMANDS );
+
+    CHECK( numExecuted == NUM_COMMANDS );
+
+    // Sending: encode every message straight to the stream
+    stream.numWritten = 0;
+    start = std::chrono::steady_clock::now();
+
+    for ( int i = 0; i < NUM_MESSAGES; i++ )
+    {
+        commander.sendResponse( (long) i );
+    }
+
+    double sendTime = elapsedNanoseconds( start, NUM_MESSAGES );
+
+    CHECK( stream.numWritten > 0 );
+
+    printf( "%-8s %10.1f %14.1f %10.2f %14.1f\n", codec->getName(), (double) command.size(), receiveTime, (double) stream.numWritten / NUM_MESSAGES, sendTime );
+}
+
+int main()
+{
+    commander.init();
+    commander.addCommand( "nop", commandNop );
+    commander.setSpanTransport( &transport );
+
+    printf( "%-8s %10s %14s %10s %14s\n", "codec", "B/command", "ns/command", "B/message", "ns/message" );
+
+    benchmark( &textCodec );
+    benchmark( &binaryCodec );
+    benchmark( &messagePackCodec );
+
+    commander.setCodec( nullptr );
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,131 @@
+/*
+    Copyright 2019 Jan-Eric Schober
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+// Codecs: commands get decoded with their arguments intact (including zero bytes), and confirm a negotiated switch of the codec.
+
+#include "Test.hpp"
+
+// StreamCommander Library
+#include <StreamCommander.hpp>
+
+// C++ Standard Libraries
+#include <chrono>
+#include <string>
+#include <thread>
+
+// An ID beyond the registered commands, so the command ends up at the default callback
+static const int UNKNOWN_COMMAND_ID = 200;
+
+// Custom codec, which only differs from the text codec by its' name, and decodes lines with the Codec helpers
+class LineCodec : public TextCodec
+{
+public:
+    const char * getName() override
+    {
+        return "lines";
+    }
+};
+
+// Global, just like in a sketch, so all members start zero-initialized
+MockStream stream;
+StreamCommander commander( &stream );
+BinaryCodec binaryCodec;
+MessagePackCodec messagePackCodec;
+LineCodec lineCodec;
+
+static std::string lastCommand;
+static std::string lastArguments;
+
+void commandDefault( String command, String arguments, StreamCommander * instance )
+{
+    lastCommand = command.str();
+    lastArguments = arguments.str();
+}
+
+// Feeds the given bytes, executes the resulting command, and returns its' arguments.
+static std::string receive( const std::string & bytes )
+{
+    lastCommand.clear();
+    lastArguments.clear();
+
+    stream.feed( bytes );
+    commander.fetchCommand();
+
+    return lastArguments;
+}
+
+static void testZeroBytes()
+{
+    const std::string arguments( "\x01\x00\x02\x03", 4 );
+
+    // Frame: <length><command ID><arguments>
+    commander.setCodec( &binaryCodec );
+
+    CHECK( receive( std::string( 1, (char) ( 1 + arguments.size() ) ) + (char) UNKNOWN_COMMAND_ID + arguments ) == arguments );
+    CHECK( lastCommand == std::to_string( UNKNOWN_COMMAND_ID ) );
+
+    // [<command ID>, bin 8]
+    commander.setCodec( &messagePackCodec );
+
+    CHECK( receive( std::string( "\x92\xcc" ) + (char) UNKNOWN_COMMAND_ID + "\xc4" + (char) arguments.size() + arguments ) == arguments );
+    CHECK( lastCommand == std::to_string( UNKNOWN_COMMAND_ID ) );
+
+    // The same goes for str 8
+    CHECK( receive( std::string( "\x92\xcc" ) + (char) UNKNOWN_COMMAND_ID + "\xd9" + (char) arguments.size() + arguments ) == arguments );
+
+    commander.setCodec( nullptr );
+}
+
+// Switches to the custom codec, feeds the given bytes, and returns the codec in use once the fallback timeout has passed.
+static Codec * switchAndWait( const std::string & bytes )
+{
+    receive( "mode lines\n" );
+    CHECK( commander.getCodec() == &lineCodec );
+
+    receive( bytes );
+    std::this_thread::sleep_for( std::chrono::milliseconds( 100 ) );
+    commander.fetchCommand();
+
+    Codec * codec = commander.getCodec();
+    commander.setCodec( nullptr );
+
+    return codec;
+}
+
+static void testCustomCodecConfirmation()
+{
+    commander.addCodec( &lineCodec );
+    commander.setModeFallbackTimeout( 50 );
+
+    // A command received by the custom codec confirms the switch
+    CHECK( switchAndWait( "anything\n" ) == &lineCodec );
+    CHECK( lastCommand == "anything" );
+
+    // Without one, the device falls back to text
+    CHECK( switchAndWait( "" ) != &lineCodec );
+}
+
+int main()
+{
+    commander.init();
+    commander.setDefaultCallback( commandDefault );
+    stream.takeOutput();
+
+    testZeroBytes();
+    testCustomCodecConfirmation();
+
+    return EXIT_SUCCESS;
+}
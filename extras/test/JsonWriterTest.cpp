@@ -0,0 +1,99 @@
+/*
+    Copyright 2019 Jan-Eric Schober
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+// JSON writer: commas, escaping and numbers of any magnitude, which must always result in valid JSON.
+
+#include "Test.hpp"
+
+// StreamCommander Library
+#include <StreamCommander.hpp>
+
+// C++ Standard Libraries
+#include <string>
+
+// Print which collects everything written to it
+class StringOutput : public Print
+{
+public:
+    std::string content;
+
+    size_t write( uint8_t character ) override
+    {
+        content += (char) character;
+
+        return 1;
+    }
+};
+
+static void testDocument()
+{
+    StringOutput output;
+    JsonWriter writer( output );
+
+    writer.beginObject();
+    writer.writeKey( "a" );
+    writer.writeInt( 1 );
+    writer.writeKey( "b" );
+    writer.beginArray();
+    writer.writeFloat( 1.5 );
+    writer.writeBool( true );
+    writer.writeNull();
+    writer.beginObject();
+    writer.endObject();
+    writer.endArray();
+    writer.writeKey( "c" );
+    writer.writeString( "x\"y\\\n\x01" );
+    writer.endObject();
+
+    CHECK( output.content == "{\"a\":1,\"b\":[1.50,true,null,{}],\"c\":\"x\\\"y\\\\\\n\\u0001\"}" );
+}
+
+// Writes a single number into an array, and returns the number as written.
+static std::string writeFloat( double value, byte decimals = 2 )
+{
+    StringOutput output;
+    JsonWriter writer( output );
+
+    writer.beginArray();
+    writer.writeFloat( value, decimals );
+    writer.endArray();
+
+    return output.content.substr( 1, output.content.length() - 2 );
+}
+
+static void testNumbers()
+{
+    CHECK( writeFloat( -0.25 ) == "-0.25" );
+    CHECK( writeFloat( 3, 0 ) == "3" );
+
+    // JSON knows neither NaN nor infinity
+    CHECK( writeFloat( NAN ) == "null" );
+    CHECK( writeFloat( -INFINITY ) == "null" );
+
+    // Beyond 32 bits as fixed-point, and beyond 64 bits in scientific notation
+    CHECK( writeFloat( -5e12 ) == "-5000000000000.00" );
+    CHECK( writeFloat( 1e30 ) == "1.00e30" );
+    CHECK( writeFloat( -1e300, 6 ) == "-1.000000e300" );
+    CHECK( writeFloat( 9.999e30 ) == "1.00e31" );
+}
+
+int main()
+{
+    testDocument();
+    testNumbers();
+
+    return EXIT_SUCCESS;
+}
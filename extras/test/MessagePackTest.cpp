@@ -0,0 +1,153 @@
+/*
+    Copyright 2019 Jan-Eric Schober
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+// MessagePack: the writer picks the shortest encoding of every value, and structured statuses (which may contain zero bytes) detect changes and get sent intact.
+
+#include "Test.hpp"
+
+// StreamCommander Library
+#include <StreamCommander.hpp>
+
+// C++ Standard Libraries
+#include <string>
+
+// Print which collects everything written to it as hex digits
+class HexPrint : public Print
+{
+public:
+    std::string content;
+
+    size_t write( uint8_t character ) override
+    {
+        char digits[3];
+        snprintf( digits, sizeof( digits ), "%02x", character );
+        content += digits;
+
+        return 1;
+    }
+
+    // Returns everything written so far, and clears it.
+    std::string take()
+    {
+        std::string written;
+        written.swap( content );
+
+        return written;
+    }
+};
+
+// Global, just like in a sketch, so all members start zero-initialized
+MockStream stream;
+StreamCommander commander( &stream );
+
+static void testWriter()
+{
+    HexPrint output;
+    MessagePackWriter writer( output );
+
+    writer.writeNil();
+    writer.writeBool( true );
+    writer.writeBool( false );
+    CHECK( output.take() == "c0c3c2" );
+
+    // Fixints, then the smallest int and uint which fits
+    writer.writeInt( 5 );
+    writer.writeInt( -1 );
+    writer.writeInt( -33 );
+    writer.writeInt( 200 );
+    writer.writeInt( -200 );
+    writer.writeInt( 70000 );
+    CHECK( output.take() == "05ff" "d0df" "ccc8" "d1ff38" "ce00011170" );
+
+    writer.writeInt( 1LL << 40 );
+    writer.writeInt( -( 1LL << 40 ) );
+    CHECK( output.take() == "cf0000010000000000" "d3ffffff0000000000" );
+
+    writer.writeFloat( 1.5f );
+    writer.writeDouble( 1.5 );
+    CHECK( output.take() == "ca3fc00000" "cb3ff8000000000000" );
+
+    writer.writeString( "abc" );
+    writer.writeString( std::string( 40, 'x' ).c_str() );
+    std::string expected = "a3616263" "d928";
+
+    for ( int i = 0; i < 40; i++ )
+    {
+        expected += "78";
+    }
+
+    CHECK( output.take() == expected );
+
+    const uint8_t binary[] = { 0x01, 0x00, 0x02 };
+    writer.writeBinary( binary, sizeof( binary ) );
+    writer.beginArray( 2 );
+    writer.beginArray( 20 );
+    writer.beginMap( 1 );
+    CHECK( output.take() == "c403010002" "92" "dc0014" "81" );
+}
+
+// Writes a structured status [first, second], which contains zero bytes as long as one of them is 0.
+static void updateStructuredStatus( int first, int second )
+{
+    MessagePackWriter & status = commander.beginStructuredStatus();
+    status.beginArray( 2 );
+    status.writeInt( first );
+    status.writeInt( second );
+    commander.endStructuredStatus();
+}
+
+static void testStructuredStatus()
+{
+    stream.takeOutput();
+
+    // The text codec sends MessagePack as hex digits
+    updateStructuredStatus( 0, 0 );
+    CHECK( stream.takeOutput() == "status:920000\r\n" );
+
+    // Unchanged statuses don't get sent again, but changes behind a zero byte do
+    updateStructuredStatus( 0, 0 );
+    CHECK( stream.takeOutput().empty() );
+
+    updateStructuredStatus( 0, 1 );
+    CHECK( stream.takeOutput() == "status:920001\r\n" );
+
+    // The whole status is kept, so it can be requested again
+    stream.feed( "getstatus\n" );
+    commander.fetchCommand();
+    CHECK( stream.takeOutput().find( "status:920001\r\n" ) != std::string::npos );
+    CHECK( commander.getStatus().length() == 3 );
+
+    // While hashing, only the hash gets compared
+    commander.setStatusHashing( true );
+
+    updateStructuredStatus( 0, 1 );
+    CHECK( stream.takeOutput().empty() );
+
+    updateStructuredStatus( 1, 0 );
+    CHECK( stream.takeOutput() == "status:920100\r\n" );
+
+    commander.setStatusHashing( false );
+}
+
+int main()
+{
+    commander.init();
+
+    testWriter();
+    testStructuredStatus();
+
+    return EXIT_SUCCESS;
+}
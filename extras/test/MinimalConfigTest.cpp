@@ -0,0 +1,90 @@
+/*
+    Copyright 2019 Jan-Eric Schober
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+// Minimal configuration: with split mode, queued transmit and telemetry compiled out, and small queues, commands still work and the instance takes less RAM.
+// Built against the StreamCommanderMinimal library (see CMakeLists.txt), so STREAMCOMMANDER_SPLIT_MODE etc. are 0 here.
+
+#include "Test.hpp"
+
+// StreamCommander Library
+#include <StreamCommander.hpp>
+
+// C++ Standard Libraries
+#include <string>
+
+// Global, just like in a sketch, so all members start zero-initialized
+MockStream stream;
+StreamCommander commander( &stream );
+
+int numMoves = 0;
+
+void commandMove( String arguments, StreamCommander * instance )
+{
+    numMoves++;
+    instance->sendResponse( arguments );
+}
+
+// Feeds the given line, executes it, and returns the output.
+static std::string command( const std::string & line )
+{
+    stream.feed( line + "\n" );
+    commander.fetchCommand();
+
+    return stream.takeOutput();
+}
+
+int main()
+{
+    static_assert( !STREAMCOMMANDER_SPLIT_MODE && !STREAMCOMMANDER_QUEUED_TRANSMIT && !STREAMCOMMANDER_TELEMETRY, "Expected the minimal configuration" );
+    static_assert( STREAMCOMMANDER_COMMAND_QUEUE_SIZE == 2, "Expected the minimal configuration" );
+
+    printf( "sizeof( StreamCommander ) = %u bytes\n", (unsigned int) sizeof( StreamCommander ) );
+
+    commander.init();
+    commander.addCommand( "move", commandMove );
+    stream.takeOutput();
+
+    // Commands get executed as usual
+    CHECK( command( "move 12" ) == "response:12\r\n" );
+    CHECK( command( "ping" ).compare( 0, 5, "ping:" ) == 0 );
+
+    // Several commands in one go still fit through the smaller command queue
+    stream.feed( "move 1\nmove 2\nmove 3\n" );
+
+    for ( int i = 0; i < 3; i++ )
+    {
+        commander.fetchCommand();
+    }
+
+    CHECK( numMoves == 4 );
+    CHECK( stream.takeOutput() == "response:1\r\nresponse:2\r\nresponse:3\r\n" );
+
+    // The compiled-out features report an error, and stay disabled
+    commander.setSplitMode( true );
+    CHECK( stream.takeOutput().compare( 0, 6, "error:" ) == 0 );
+    CHECK( !commander.isSplitMode() );
+
+    commander.setQueuedTransmit( true );
+    CHECK( stream.takeOutput().compare( 0, 6, "error:" ) == 0 );
+    CHECK( !commander.isQueuedTransmit() );
+    CHECK( commander.getNumDroppedMessages() == 0 );
+
+    // The keyframe-command doesn't exist without telemetry
+    CHECK( command( "keyframe" ).find( "not registered" ) != std::string::npos );
+    CHECK( command( "schema" ).find( " keyframe " ) == std::string::npos );
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,157 @@
+/*
+    Copyright 2019 Jan-Eric Schober
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+// Numeric statuses and responses: numbers get formatted exactly, at their limits too, and statuses only get sent if their value has changed.
+
+#include "Test.hpp"
+
+// StreamCommander Library
+#include <StreamCommander.hpp>
+
+// C++ Standard Libraries
+#include <climits>
+#include <cmath>
+#include <string>
+
+// Global, just like in a sketch, so all members start zero-initialized
+MockStream stream;
+StreamCommander commander( &stream );
+
+// Returns the status message sent since the last call, or an empty string if there was none.
+static std::string sentStatus()
+{
+    std::string output = stream.takeOutput();
+
+    if ( output.empty() )
+    {
+        return output;
+    }
+
+    CHECK( output.compare( 0, 7, "status:" ) == 0 );
+    CHECK( output.compare( output.size() - 2, 2, "\r\n" ) == 0 );
+
+    return output.substr( 7, output.size() - 9 );
+}
+
+int main()
+{
+    commander.init();
+    stream.takeOutput();
+
+    // Integers, up to the limits of their types
+    commander.updateStatus( 42 );
+    CHECK( sentStatus() == "42" );
+    CHECK( commander.getStatus() == "42" );
+
+    commander.updateStatus( 42 );
+    CHECK( sentStatus() == "" );
+
+    // The same status as text isn't a change either
+    commander.updateStatus( String( "42" ) );
+    CHECK( sentStatus() == "" );
+
+    commander.updateStatus( INT_MIN );
+    CHECK( sentStatus() == std::to_string( INT_MIN ) );
+
+    commander.updateStatus( UINT_MAX );
+    CHECK( sentStatus() == std::to_string( UINT_MAX ) );
+
+    commander.updateStatus( LONG_MIN );
+    CHECK( sentStatus() == std::to_string( LONG_MIN ) );
+
+    commander.updateStatus( ULONG_MAX );
+    CHECK( sentStatus() == std::to_string( ULONG_MAX ) );
+
+    commander.updateStatus( ULONG_MAX );
+    CHECK( sentStatus() == "" );
+
+    // Floating-point numbers get rounded to their decimals, and changes below them don't count
+    commander.updateStatus( 3.14159, 2 );
+    CHECK( sentStatus() == "3.14" );
+
+    commander.updateStatus( 3.141, 2 );
+    CHECK( sentStatus() == "" );
+
+    commander.updateStatus( 0.125, 2 );
+    CHECK( sentStatus() == "0.13" );
+
+    commander.updateStatus( -0.5, 1 );
+    CHECK( sentStatus() == "-0.5" );
+
+    // No negative zero
+    commander.updateStatus( -0.004, 2 );
+    CHECK( sentStatus() == "0.00" );
+
+    // Decimals are limited to MAX_DECIMALS
+    commander.updateStatus( 2.5, 9 );
+    CHECK( sentStatus() == "2.500000" );
+
+    // Numbers beyond a fixed-point number, and non-finite ones
+    commander.updateStatus( 1e30, 2 );
+    CHECK( sentStatus() == "1.00e30" );
+
+    commander.updateStatus( -1e30, 2 );
+    CHECK( sentStatus() == "-1.00e30" );
+
+    commander.updateStatus( NAN, 2 );
+    CHECK( sentStatus() == "nan" );
+
+    commander.updateStatus( -INFINITY, 2 );
+    CHECK( sentStatus() == "-inf" );
+
+    // Arrays get compared value by value
+    int values[3] = { 1, -2, 3 };
+
+    commander.updateStatus( values, 3 );
+    CHECK( sentStatus() == "1,-2,3" );
+
+    commander.updateStatus( values, 3 );
+    CHECK( sentStatus() == "" );
+
+    values[2] = INT_MAX;
+    commander.updateStatus( values, 3 );
+    CHECK( sentStatus() == "1,-2," + std::to_string( INT_MAX ) );
+
+    float floatValues[2] = { 1.5f, 2.25f };
+
+    commander.updateStatus( floatValues, 2, 2 );
+    CHECK( sentStatus() == "1.50,2.25" );
+
+    commander.updateStatus( floatValues, 2, 2 );
+    CHECK( sentStatus() == "" );
+
+    // Too many values get rejected as a whole, instead of being cut off
+    int manyValues[9] = { 0 };
+
+    commander.updateStatus( manyValues, 9 );
+    CHECK( stream.takeOutput().compare( 0, 6, "error:" ) == 0 );
+    CHECK( commander.getStatus() == "1.50,2.25" );
+
+    // Responses use the same formatting
+    commander.sendResponse( -7 );
+    CHECK( stream.takeOutput() == "response:-7\r\n" );
+
+    commander.sendResponse( ULONG_MAX );
+    CHECK( stream.takeOutput() == "response:" + std::to_string( ULONG_MAX ) + "\r\n" );
+
+    commander.sendResponse( 2.0 / 3, 3 );
+    CHECK( stream.takeOutput() == "response:0.667\r\n" );
+
+    commander.sendResponse( values, 3 );
+    CHECK( stream.takeOutput() == "response:1,-2," + std::to_string( INT_MAX ) + "\r\n" );
+
+    return EXIT_SUCCESS;
+}
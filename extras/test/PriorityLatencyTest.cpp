@@ -0,0 +1,119 @@
+/*
+    Copyright 2019 Jan-Eric Schober
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+// Latency of priority and fast commands: a backlog of regular commands, which overruns the command queue, must not delay them.
+// The regular commands behind the queue get dropped and reported, instead of blocking the stream.
+
+#include "Test.hpp"
+
+// StreamCommander Library
+#include <StreamCommander.hpp>
+
+// C++ Standard Libraries
+#include <string>
+
+static const int NUM_SLOW = 30;
+
+// Global, just like in a sketch, so all members start zero-initialized
+MockStream stream;
+StreamCommander commander( &stream );
+
+static int numSlowExecuted = 0;
+static int numSlowBeforeStop = -1;
+static int numSlowBeforeEstop = -1;
+
+void commandSlow( String arguments, StreamCommander * instance )
+{
+    numSlowExecuted++;
+}
+
+void commandStop( String arguments, StreamCommander * instance )
+{
+    numSlowBeforeStop = numSlowExecuted;
+}
+
+void commandEstop( StreamCommander * instance )
+{
+    numSlowBeforeEstop = numSlowExecuted;
+}
+
+// Feeds a backlog of slow commands followed by the given bytes.
+static void feedBehindBacklog( const std::string & bytes )
+{
+    std::string input;
+
+    for ( int i = 0; i < NUM_SLOW; i++ )
+    {
+        input += "slow\n";
+    }
+
+    numSlowExecuted = 0;
+    stream.feed( input + bytes );
+}
+
+// Executes all commands which are still queued.
+static void drainQueue()
+{
+    while ( commander.getNumQueuedCommands() > 0 )
+    {
+        commander.fetchCommand();
+    }
+
+    commander.fetchCommand();
+}
+
+int main()
+{
+    commander.init();
+    commander.addCommand( "slow", commandSlow );
+    commander.addPriorityCommand( "stop", commandStop );
+    commander.addFastCommand( '\x03', commandEstop );
+    stream.takeOutput();
+
+    // The whole backlog gets read at once, so the priority command runs before any regular one
+    feedBehindBacklog( "stop\n" );
+    commander.fetchCommand();
+
+    CHECK( numSlowBeforeStop == 0 );
+    CHECK( stream.available() == 0 );
+
+    drainQueue();
+
+    // The queue holds COMMAND_QUEUE_SIZE commands plus one held back by the receiving side; the rest got reported
+    CHECK( numSlowExecuted == 9 );
+    CHECK( stream.takeOutput().find( "error:Command queue full, dropped 21 command(s)" ) != std::string::npos );
+
+    // The same goes for fast commands
+    feedBehindBacklog( "\x03" );
+    commander.fetchCommand();
+
+    CHECK( numSlowBeforeEstop == 0 );
+
+    drainQueue();
+
+    // Split mode: the priority command gets queued separately, and runs on the next dispatchCommands()
+    commander.setSplitMode( true );
+    numSlowBeforeStop = -1;
+
+    feedBehindBacklog( "stop\n" );
+    commander.receiveCommands();
+    commander.dispatchCommands();
+
+    CHECK( numSlowBeforeStop == 0 );
+    CHECK( numSlowExecuted == 1 );
+
+    return EXIT_SUCCESS;
+}
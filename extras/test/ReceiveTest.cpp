@@ -0,0 +1,160 @@
+/*
+    Copyright 2019 Jan-Eric Schober
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+// Receiving side: bytes get read in whole chunks, the word-wise line scan finds stop bytes at every alignment,
+// and overlong lines get discarded or truncated according to the overflow policy.
+
+#include "Test.hpp"
+
+// StreamCommander Library
+#include <StreamCommander.hpp>
+
+// C++ Standard Libraries
+#include <string>
+
+// Counts the calls of readBytes()
+class CountingStream : public MockStream
+{
+public:
+    int numReads = 0;
+
+    size_t readBytes( char * buffer, size_t length ) override
+    {
+        numReads++;
+
+        return MockStream::readBytes( buffer, length );
+    }
+};
+
+// Global, just like in a sketch, so all members start zero-initialized
+CountingStream stream;
+StreamCommander commander( &stream );
+
+static std::string lastArguments;
+static int numExecuted = 0;
+static int numEstops = 0;
+
+void commandLine( String arguments, StreamCommander * instance )
+{
+    lastArguments = arguments.str();
+    numExecuted++;
+}
+
+void commandEstop( StreamCommander * instance )
+{
+    numEstops++;
+}
+
+// Feeds the given bytes, executes the resulting commands, and returns the number of readBytes() calls it took.
+static int receive( const std::string & bytes )
+{
+    stream.numReads = 0;
+    stream.feed( bytes );
+    commander.fetchCommand();
+
+    return stream.numReads;
+}
+
+static void testChunkedReads()
+{
+    // A line of 105 bytes fits into 4 chunks of RECEIVE_CHUNK_SIZE bytes
+    std::string arguments( 105 - 6, 'a' );
+
+    CHECK( receive( "line " + arguments + "\n" ) <= 4 );
+    CHECK( numExecuted == 1 );
+    CHECK( lastArguments == arguments );
+
+    // Neither does split mode read less at once
+    commander.setSplitMode( true );
+
+    stream.numReads = 0;
+    stream.feed( "line " + arguments + "\n" );
+    commander.receiveCommands();
+    commander.dispatchCommands();
+
+    CHECK( stream.numReads <= 4 );
+    CHECK( numExecuted == 2 );
+
+    commander.setSplitMode( false );
+}
+
+static void testScanAlignment()
+{
+    // Move the delimiter, the fast command trigger and the line ending across all positions of a word
+    for ( int offset = 0; offset < 16; offset++ )
+    {
+        std::string padding( offset, 'p' );
+        int numEstopsBefore = numEstops;
+
+        numExecuted = 0;
+        receive( "line " + padding + "\x03" + "x y\r\n" );
+
+        CHECK( numExecuted == 1 );
+        CHECK( numEstops == numEstopsBefore + 1 );
+        CHECK( lastArguments == padding + "x y" );
+
+        // Stop bytes with the high bit set must not be mistaken for others
+        receive( std::string( "line " ) + padding + "\x83\xff\n" );
+
+        CHECK( numExecuted == 2 );
+        CHECK( lastArguments == padding + "\x83\xff" );
+    }
+}
+
+static void testOverflowPolicies()
+{
+    std::string arguments( 20, 'a' );
+
+    commander.setMaxLineLength( 16 );
+    stream.takeOutput();
+
+    // Discarded lines don't get executed, but reported
+    numExecuted = 0;
+    receive( "line " + arguments + "\nline short\n" );
+    commander.fetchCommand();
+
+    CHECK( numExecuted == 1 );
+    CHECK( lastArguments == "short" );
+    CHECK( stream.takeOutput().find( "Line too long, discarded 1 line(s) (max line length = 16)" ) != std::string::npos );
+
+    // Truncated lines get executed with the beginning of the line
+    commander.setLineOverflowPolicy( StreamCommander::OVERFLOW_TRUNCATE );
+
+    numExecuted = 0;
+    receive( "line " + arguments + "\n" );
+    commander.fetchCommand();
+
+    CHECK( numExecuted == 1 );
+    CHECK( lastArguments == arguments.substr( 0, 16 - 5 ) );
+    CHECK( stream.takeOutput().find( "Line too long, truncated 1 line(s)" ) != std::string::npos );
+
+    commander.setLineOverflowPolicy( StreamCommander::OVERFLOW_DISCARD );
+    commander.setMaxLineLength( 128 );
+}
+
+int main()
+{
+    commander.init();
+    commander.addCommand( "line", commandLine );
+    commander.addFastCommand( '\x03', commandEstop );
+    stream.takeOutput();
+
+    testChunkedReads();
+    testScanAlignment();
+    testOverflowPolicies();
+
+    return EXIT_SUCCESS;
+}
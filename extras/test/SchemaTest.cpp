@@ -0,0 +1,83 @@
+/*
+    Copyright 2019 Jan-Eric Schober
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+// Schema: commands and message types get listed with their IDs, and the hash follows every change.
+
+#include "Test.hpp"
+
+// StreamCommander Library
+#include <StreamCommander.hpp>
+
+// C++ Standard Libraries
+#include <string>
+
+// Global, just like in a sketch, so all members start zero-initialized
+MockStream stream;
+StreamCommander commander( &stream );
+
+void commandMove( String arguments, StreamCommander * instance )
+{
+}
+
+// Feeds the given line, executes it, and returns the output.
+static std::string command( const std::string & line )
+{
+    stream.feed( line + "\n" );
+    commander.fetchCommand();
+
+    return stream.takeOutput();
+}
+
+// Returns the hash of the schema, as returned by the schemahash-command.
+static std::string schemaHash()
+{
+    std::string output = command( "schemahash" );
+
+    CHECK( output.compare( 0, 7, "schema:" ) == 0 );
+
+    return output.substr( 7, 8 );
+}
+
+int main()
+{
+    commander.init();
+    stream.takeOutput();
+
+    std::string standardHash = schemaHash();
+    std::string schema = command( "schema" );
+
+    // The full schema starts with the same hash
+    CHECK( schema.compare( 7, 8, standardHash ) == 0 );
+    CHECK( schema.find( ";9 cancel i cancelled=" + std::to_string( StreamCommander::TYPE_CANCELLED ) + ",error=" + std::to_string( StreamCommander::TYPE_ERROR ) + ";" ) != std::string::npos );
+
+    // Custom commands and message types follow the standard ones
+    int readingId = commander.addMessageType( "reading" );
+    int moveId = commander.getNumCommands();
+
+    commander.addCommand( "move", commandMove );
+    std::string undescribedHash = schemaHash();
+
+    CHECK( undescribedHash != standardHash );
+    CHECK( command( "schema" ).find( ";" + std::to_string( moveId ) + " move - -" ) != std::string::npos );
+
+    // Unregistered message types get listed without an ID
+    commander.describeCommand( "move", "if", "reading,response,unknown" );
+
+    CHECK( schemaHash() != undescribedHash );
+    CHECK( command( "schema" ).find( ";" + std::to_string( moveId ) + " move if reading=" + std::to_string( readingId ) + ",response=0,unknown" ) != std::string::npos );
+
+    return EXIT_SUCCESS;
+}
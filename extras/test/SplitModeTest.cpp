@@ -0,0 +1,162 @@
+/*
+    Copyright 2019 Jan-Eric Schober
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+// Producer/consumer test of the split mode: one thread receives commands, another one dispatches them, while commands keep arriving.
+// Commands sent with flow control (never more than the command queue holds) have to be executed exactly once and in order.
+// A flood may drop regular commands, but those which get executed keep their order, every dropped one gets counted, and priority commands still get through.
+
+#include "Test.hpp"
+
+// StreamCommander Library
+#include <StreamCommander.hpp>
+
+// C++ Standard Libraries
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+
+static const int QUEUE_SIZE = 8; // StreamCommander::COMMAND_QUEUE_SIZE
+static const int NUM_BURSTS = 200;
+static const int NUM_FLOODS = 8; // Few enough, so the number of dropped commands doesn't wrap around
+static const int FLOOD_LENGTH = 30;
+
+// Global, just like in a sketch, so all members start zero-initialized
+MockStream stream;
+StreamCommander commander( &stream );
+
+// Only written by the dispatching thread
+static std::atomic<int> numExecuted( 0 );
+static std::atomic<int> numPriorityExecuted( 0 );
+static long lastValue = -1;
+static int numOutOfOrder = 0;
+
+void commandCount( String arguments, StreamCommander * instance )
+{
+    long value = arguments.toInt();
+
+    if ( value <= lastValue )
+    {
+        numOutOfOrder++;
+    }
+
+    lastValue = value;
+    numExecuted++;
+    instance->sendResponse( arguments );
+}
+
+void commandPriority( String arguments, StreamCommander * instance )
+{
+    numPriorityExecuted++;
+}
+
+// Waits until the given number of commands has been executed or dropped.
+static bool waitForCommands( int numCommands )
+{
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::seconds( 10 );
+
+    while ( numExecuted + numPriorityExecuted + commander.getNumDroppedCommands() < numCommands )
+    {
+        if ( std::chrono::steady_clock::now() > deadline )
+        {
+            return false;
+        }
+
+        std::this_thread::yield();
+    }
+
+    return true;
+}
+
+int main()
+{
+    commander.init();
+    commander.addCommand( "count", commandCount );
+    commander.addPriorityCommand( "prio", commandPriority );
+    commander.setSplitMode( true );
+    stream.takeOutput();
+
+    std::atomic<bool> running( true );
+
+    std::thread receiver( [&running]()
+    {
+        while ( running )
+        {
+            commander.receiveCommands();
+        }
+    } );
+
+    std::thread dispatcher( [&running]()
+    {
+        while ( running )
+        {
+            commander.dispatchCommands();
+        }
+    } );
+
+    // With flow control: a burst which fits into the command queue, plus a priority command, then wait for all of them
+    int value = 0;
+    int numSent = 0;
+
+    for ( int i = 0; i < NUM_BURSTS; i++ )
+    {
+        std::string burst;
+
+        for ( int j = 0; j < QUEUE_SIZE; j++ )
+        {
+            burst += "count " + std::to_string( value++ ) + "\n";
+        }
+
+        burst += "prio\n";
+        numSent += QUEUE_SIZE + 1;
+        stream.feed( burst );
+
+        CHECK( waitForCommands( numSent ) );
+    }
+
+    CHECK( commander.getNumDroppedCommands() == 0 );
+    CHECK( numExecuted == NUM_BURSTS * QUEUE_SIZE );
+    CHECK( numPriorityExecuted == NUM_BURSTS );
+
+    // Without flow control: floods which overrun the command queue, each followed by a priority command
+    for ( int i = 0; i < NUM_FLOODS; i++ )
+    {
+        std::string flood;
+
+        for ( int j = 0; j < FLOOD_LENGTH; j++ )
+        {
+            flood += "count " + std::to_string( value++ ) + "\n";
+        }
+
+        flood += "prio\n";
+        numSent += FLOOD_LENGTH + 1;
+        stream.feed( flood );
+
+        CHECK( waitForCommands( numSent ) );
+    }
+
+    running = false;
+    receiver.join();
+    dispatcher.join();
+
+    CHECK( numOutOfOrder == 0 );
+    CHECK( numPriorityExecuted == NUM_BURSTS + NUM_FLOODS );
+    CHECK( numExecuted + numPriorityExecuted + commander.getNumDroppedCommands() == numSent );
+
+    printf( "%d commands and %d priority commands executed, %d dropped\n", (int) numExecuted, (int) numPriorityExecuted, commander.getNumDroppedCommands() );
+
+    return EXIT_SUCCESS;
+}
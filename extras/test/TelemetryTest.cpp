@@ -0,0 +1,190 @@
+/*
+    Copyright 2019 Jan-Eric Schober
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+// Telemetry: a host which adds up the decoded differences gets the exact values back (even across the wraparound of 32 bit values),
+// keyframes get sent when required, and the bytes on the wire are reported for the binary and the text codec.
+
+#include "Test.hpp"
+
+// StreamCommander Library
+#include <StreamCommander.hpp>
+
+// C++ Standard Libraries
+#include <string>
+#include <vector>
+
+static const int NUM_VALUES = 3;
+static const byte TELEMETRY_KEYFRAME = 0x80;
+
+// Global, just like in a sketch, so all members start zero-initialized
+MockStream stream;
+StreamCommander commander( &stream );
+BinaryCodec binaryCodec;
+
+// Decodes telemetry messages like a host would, and keeps the reconstructed values.
+class TelemetryDecoder
+{
+public:
+    uint32_t values[NUM_VALUES] = {};
+    bool keyframe = false;
+    byte sequence = 0;
+
+    // Decodes the content of a telemetry message.
+    void decode( const std::string & content )
+    {
+        size_t position = 0;
+        byte flags = content[position++];
+        CHECK( ( flags & ~TELEMETRY_KEYFRAME ) == NUM_VALUES );
+
+        keyframe = flags & TELEMETRY_KEYFRAME;
+        sequence = content[position++];
+
+        for ( int i = 0; i < NUM_VALUES; i++ )
+        {
+            uint32_t zigzag = 0;
+            int shift = 0;
+            byte character;
+
+            do
+            {
+                CHECK( position < content.length() );
+                character = content[position++];
+                zigzag |= (uint32_t) ( character & 0x7F ) << shift;
+                shift += 7;
+            } while ( character & 0x80 );
+
+            uint32_t difference = ( zigzag >> 1 ) ^ -( zigzag & 1 );
+            values[i] = keyframe ? difference : values[i] + difference;
+        }
+
+        CHECK( position == content.length() );
+    }
+};
+
+// Converts the hex digits of the text codec back to bytes.
+static std::string fromHex( const std::string & digits )
+{
+    std::string bytes;
+
+    for ( size_t i = 0; i + 1 < digits.length(); i += 2 )
+    {
+        bytes += (char) std::stoi( digits.substr( i, 2 ), nullptr, 16 );
+    }
+
+    return bytes;
+}
+
+// Sends a sample in the text codec, and returns the content of the resulting message.
+static std::string sendText( const int32_t * values )
+{
+    commander.sendTelemetry( values, NUM_VALUES );
+    std::string output = stream.takeOutput();
+
+    CHECK( output.compare( 0, 10, "telemetry:" ) == 0 );
+
+    return fromHex( output.substr( 10, output.length() - 12 ) );
+}
+
+static void testRoundTrip()
+{
+    TelemetryDecoder decoder;
+    int32_t values[NUM_VALUES] = { 2345, 101325, 456 };
+    std::vector<int32_t> steps = { 2, -1, 0, 1000000, INT32_MAX, -7 };
+
+    for ( size_t sample = 0; sample < 40; sample++ )
+    {
+        // Values wrap around, just like the differences
+        for ( int i = 0; i < NUM_VALUES; i++ )
+        {
+            values[i] = (int32_t) ( (uint32_t) values[i] + (uint32_t) steps[( sample + i ) % steps.size()] );
+        }
+
+        decoder.decode( sendText( values ) );
+
+        CHECK( decoder.sequence == (byte) sample );
+        CHECK( decoder.keyframe == ( sample % 16 == 0 ) );
+
+        for ( int i = 0; i < NUM_VALUES; i++ )
+        {
+            CHECK( (int32_t) decoder.values[i] == values[i] );
+        }
+    }
+
+    // A requested keyframe is the next sample
+    stream.feed( "keyframe\n" );
+    commander.fetchCommand();
+    stream.takeOutput();
+
+    decoder.decode( sendText( values ) );
+    CHECK( decoder.keyframe );
+
+    // So is a change of the number of values
+    commander.sendTelemetry( values, 1 );
+    stream.takeOutput();
+    decoder.decode( sendText( values ) );
+    CHECK( decoder.keyframe );
+}
+
+static void testBytesOnTheWire()
+{
+    int32_t values[NUM_VALUES] = { 2345, 101325, 456 };
+
+    // The same values as text, for comparison
+    commander.sendMessage( StreamCommander::TYPE_STATUS, "2345,101325,456" );
+    int textLength = stream.takeOutput().length();
+
+    commander.requestTelemetryKeyframe();
+    commander.sendTelemetry( values, NUM_VALUES );
+    int textKeyframeLength = stream.takeOutput().length();
+
+    values[0] += 2;
+    values[1] -= 1;
+    commander.sendTelemetry( values, NUM_VALUES );
+    int textDeltaLength = stream.takeOutput().length();
+
+    commander.setCodec( &binaryCodec );
+
+    commander.requestTelemetryKeyframe();
+    commander.sendTelemetry( values, NUM_VALUES );
+    int binaryKeyframeLength = stream.takeOutput().length();
+
+    values[0] += 2;
+    values[1] -= 1;
+    commander.sendTelemetry( values, NUM_VALUES );
+    int binaryDeltaLength = stream.takeOutput().length();
+
+    commander.setCodec( nullptr );
+
+    printf( "Bytes of 3 values: %d as text, telemetry in the text codec %d (keyframe) / %d (delta), in the binary codec %d (keyframe) / %d (delta)\n",
+        textLength, textKeyframeLength, textDeltaLength, binaryKeyframeLength, binaryDeltaLength );
+
+    // The gain lies in the binary codecs; as hex digits, a keyframe even takes more than the text
+    CHECK( binaryDeltaLength * 3 <= textLength );
+    CHECK( binaryKeyframeLength < textLength );
+    CHECK( textDeltaLength < textLength );
+    CHECK( textKeyframeLength > textLength );
+}
+
+int main()
+{
+    commander.init();
+    stream.takeOutput();
+
+    testRoundTrip();
+    testBytesOnTheWire();
+
+    return EXIT_SUCCESS;
+}
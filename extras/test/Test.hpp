@@ -0,0 +1,35 @@
+/*
+    Copyright 2019 Jan-Eric Schober
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#ifndef TEST_HPP
+#define TEST_HPP
+
+// C++ Standard Libraries
+#include <cstdio>
+#include <cstdlib>
+
+// Checks a condition, even if NDEBUG is defined, and exits with a failure if it doesn't hold.
+#define CHECK( condition ) \
+    do \
+    { \
+        if ( !( condition ) ) \
+        { \
+            fprintf( stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition ); \
+            exit( EXIT_FAILURE ); \
+        } \
+    } while ( false )
+
+#endif // TEST_HPP
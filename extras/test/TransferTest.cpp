@@ -0,0 +1,162 @@
+/*
+    Copyright 2019 Jan-Eric Schober
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+// Bulk transfers: pulls within the window, pushes whose chunks have to fit into a line, and malformed sequence numbers.
+
+#include "Test.hpp"
+
+// StreamCommander Library
+#include <StreamCommander.hpp>
+
+// C++ Standard Libraries
+#include <string>
+#include <vector>
+
+static const int DATA_SIZE = 100;
+
+// Global, just like in a sketch, so all members start zero-initialized
+MockStream stream;
+StreamCommander commander( &stream );
+
+static std::vector<byte> pulledData;
+static std::vector<byte> pushedData;
+
+int readData( unsigned long offset, byte * buffer, int length, StreamCommander * instance )
+{
+    int available = offset < pulledData.size() ? pulledData.size() - offset : 0;
+    length = min( length, available );
+    memcpy( buffer, pulledData.data() + offset, length );
+
+    return length;
+}
+
+int writeData( unsigned long offset, const byte * buffer, int length, StreamCommander * instance )
+{
+    pushedData.resize( max( pushedData.size(), offset + length ) );
+    memcpy( pushedData.data() + offset, buffer, length );
+
+    return length;
+}
+
+// Feeds the given line, executes it, and returns the output.
+static std::string command( const std::string & line )
+{
+    stream.feed( line + "\n" );
+    commander.fetchCommand();
+
+    return stream.takeOutput();
+}
+
+// Counts the occurrences of a text in the output.
+static int count( const std::string & output, const std::string & text )
+{
+    int occurrences = 0;
+
+    for ( size_t position = output.find( text ); position != std::string::npos; position = output.find( text, position + 1 ) )
+    {
+        occurrences++;
+    }
+
+    return occurrences;
+}
+
+// Returns a push-chunk as "chunk <sequence> <hex-data> <checksum>", optionally with a corrupted checksum.
+static std::string chunkLine( const std::string & sequence, const byte * data, int length, bool corrupt = false )
+{
+    uint16_t crc = 0xFFFF;
+    std::string line = "chunk " + sequence + " ";
+    char digits[5];
+
+    for ( int i = 0; i < length; i++ )
+    {
+        snprintf( digits, sizeof( digits ), "%02x", data[i] );
+        line += digits;
+        crc ^= (uint16_t) data[i] << 8;
+
+        for ( int bit = 0; bit < 8; bit++ )
+        {
+            crc = ( crc & 0x8000 ) ? ( crc << 1 ) ^ 0x1021 : crc << 1;
+        }
+    }
+
+    snprintf( digits, sizeof( digits ), "%04x", (uint16_t) ( corrupt ? crc ^ 1 : crc ) );
+
+    return line + " " + digits;
+}
+
+static void testPull()
+{
+    // 100 bytes in chunks of 32 take 4 chunks, which all fit into the window
+    std::string output = command( "pull data" );
+    commander.fetchCommand();
+    output += stream.takeOutput();
+
+    CHECK( output.find( "transfer:pull data 32 4" ) != std::string::npos );
+    CHECK( count( output, "chunk:" ) == 4 );
+    CHECK( output.find( "chunk:3 " ) != std::string::npos );
+
+    // Anything which isn't a sequence number gets rejected, instead of being taken as 0
+    CHECK( command( "ack x" ).find( "error:Invalid sequence 'x'." ) != std::string::npos );
+    CHECK( command( "nak -1" ).find( "error:Invalid sequence '-1'." ) != std::string::npos );
+
+    CHECK( command( "ack 3" ).find( "transfer:done 100" ) != std::string::npos );
+    CHECK( !commander.isTransferring() );
+}
+
+static void testPush()
+{
+    // Chunks of 128 bytes wouldn't fit into a line, so a smaller size gets announced
+    commander.setTransferChunkSize( 128 );
+
+    CHECK( command( "push data 100" ).find( "transfer:push data 53 4" ) != std::string::npos );
+
+    // A malformed sequence number or checksum gets answered with the expected sequence
+    CHECK( command( chunkLine( "x", pulledData.data(), 53 ) ).find( "nak:0" ) != std::string::npos );
+    CHECK( command( chunkLine( "0", pulledData.data(), 53, true ) ).find( "nak:0" ) != std::string::npos );
+
+    CHECK( command( chunkLine( "0", pulledData.data(), 53 ) ).find( "ack:0" ) != std::string::npos );
+
+    std::string output = command( chunkLine( "1", pulledData.data() + 53, DATA_SIZE - 53 ) );
+
+    CHECK( output.find( "ack:1" ) != std::string::npos );
+    CHECK( output.find( "transfer:done 100" ) != std::string::npos );
+    CHECK( pushedData == pulledData );
+
+    // Too short lines can't carry any push-chunk at all
+    commander.setMaxLineLength( 20 );
+
+    CHECK( command( "push data 100" ).find( "error:Max line length too short for push-transfers" ) != std::string::npos );
+    CHECK( !commander.isTransferring() );
+
+    commander.setMaxLineLength( 128 );
+}
+
+int main()
+{
+    for ( int i = 0; i < DATA_SIZE; i++ )
+    {
+        pulledData.push_back( i * 7 );
+    }
+
+    commander.init();
+    commander.setTransferCallbacks( readData, writeData );
+    stream.takeOutput();
+
+    testPull();
+    testPush();
+
+    return EXIT_SUCCESS;
+}
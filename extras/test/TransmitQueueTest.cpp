@@ -0,0 +1,111 @@
+/*
+    Copyright 2019 Jan-Eric Schober
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+// Stress test of the queued transmit: several threads send messages concurrently, while another thread writes them to the stream.
+// Every message has to arrive intact, or be counted as dropped.
+
+#include "Test.hpp"
+
+// StreamCommander Library
+#include <StreamCommander.hpp>
+
+// C++ Standard Libraries
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+static const int NUM_PRODUCERS = 4;
+static const int NUM_MESSAGES = 5000;
+static const char PAYLOAD[] = "-abcdefghijklmnopqrstuvwxyz";
+
+// Global, just like in a sketch, so all members start zero-initialized
+MockStream stream;
+StreamCommander commander( &stream );
+
+int main()
+{
+    commander.init();
+    stream.takeOutput();
+    commander.setQueuedTransmit( true );
+
+    std::atomic<bool> producing( true );
+
+    // The transmitting thread owns the stream, just like the receiving side in split mode
+    std::thread transmitter( [&producing]()
+    {
+        while ( producing )
+        {
+            commander.transmitMessages();
+        }
+
+        commander.transmitMessages();
+    } );
+
+    std::vector<std::thread> producers;
+
+    for ( int producer = 0; producer < NUM_PRODUCERS; producer++ )
+    {
+        producers.emplace_back( [producer]()
+        {
+            for ( int i = 0; i < NUM_MESSAGES; i++ )
+            {
+                commander.sendInfo( "p" + String( producer ) + "-" + String( i ) + PAYLOAD );
+            }
+        } );
+    }
+
+    for ( std::thread & producer : producers )
+    {
+        producer.join();
+    }
+
+    producing = false;
+    transmitter.join();
+
+    // Each line has to be a complete message; interleaved or torn messages would break the format
+    std::string output = stream.takeOutput();
+    std::vector<int> lastIndex( NUM_PRODUCERS, -1 );
+    unsigned int numLines = 0;
+    size_t position = 0;
+    size_t end;
+
+    while ( ( end = output.find( "\r\n", position ) ) != std::string::npos )
+    {
+        std::string line = output.substr( position, end - position );
+        position = end + 2;
+        numLines++;
+
+        int producer = -1;
+        int index = -1;
+        int length = 0;
+
+        CHECK( sscanf( line.c_str(), "info:p%d-%d%n", &producer, &index, &length ) == 2 );
+        CHECK( producer >= 0 && producer < NUM_PRODUCERS );
+        CHECK( line.substr( length ) == PAYLOAD );
+
+        // Messages of the same producer keep their order
+        CHECK( index > lastIndex[producer] );
+        lastIndex[producer] = index;
+    }
+
+    CHECK( position == output.size() );
+    CHECK( numLines + commander.getNumDroppedMessages() == (unsigned int) ( NUM_PRODUCERS * NUM_MESSAGES ) );
+
+    printf( "%u messages transmitted, %u dropped\n", numLines, commander.getNumDroppedMessages() );
+
+    return EXIT_SUCCESS;
+}
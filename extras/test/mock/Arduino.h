@@ -0,0 +1,374 @@
+/*
+    Copyright 2019 Jan-Eric Schober
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#ifndef ARDUINO_MOCK_H
+#define ARDUINO_MOCK_H
+
+// Minimal host replacement of the Arduino core, just enough to build and test the library with a regular compiler.
+// String keeps its' contents in a std::string, and MockStream is a thread-safe in-memory Stream.
+
+// C++ Standard Libraries
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <type_traits>
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HEX 16
+#define DEC 10
+#define HIGH 1
+#define LOW 0
+#define OUTPUT 1
+#define LED_BUILTIN 13
+#define PROGMEM
+
+class __FlashStringHelper;
+#define F( string ) ( reinterpret_cast<const __FlashStringHelper *>( string ) )
+
+// Functions instead of the usual macros, so they don't clash with the C++ Standard Library
+template <typename A, typename B>
+inline typename std::common_type<A, B>::type min( A a, B b )
+{
+    return a < b ? a : b;
+}
+
+template <typename A, typename B>
+inline typename std::common_type<A, B>::type max( A a, B b )
+{
+    return a > b ? a : b;
+}
+
+unsigned long millis();
+unsigned long micros();
+
+inline void noInterrupts() {}
+inline void interrupts() {}
+inline void pinMode( int, int ) {}
+inline void digitalWrite( int, int ) {}
+
+class String
+{
+private:
+    std::string text;
+
+    template <typename T>
+    static std::string format( const char * decimalFormat, const char * hexFormat, T value, unsigned char base )
+    {
+        char buffer[40];
+        snprintf( buffer, sizeof( buffer ), base == HEX ? hexFormat : decimalFormat, value );
+
+        return buffer;
+    }
+
+public:
+    String() {}
+    String( const char * text ) : text( text != nullptr ? text : "" ) {}
+    String( const __FlashStringHelper * text ) : text( (const char *) text ) {}
+    String( const std::string & text ) : text( text ) {}
+    explicit String( char character ) : text( 1, character ) {}
+    explicit String( int value, unsigned char base = DEC ) : text( format( "%d", "%x", value, base ) ) {}
+    explicit String( unsigned int value, unsigned char base = DEC ) : text( format( "%u", "%x", value, base ) ) {}
+    explicit String( long value, unsigned char base = DEC ) : text( format( "%ld", "%lx", value, base ) ) {}
+    explicit String( unsigned long value, unsigned char base = DEC ) : text( format( "%lu", "%lx", value, base ) ) {}
+    explicit String( float value, unsigned char decimalPlaces = 2 ) : String( (double) value, decimalPlaces ) {}
+
+    explicit String( double value, unsigned char decimalPlaces = 2 )
+    {
+        char buffer[400];
+        snprintf( buffer, sizeof( buffer ), "%.*f", decimalPlaces, value );
+        text = buffer;
+    }
+
+    unsigned int length() const { return text.size(); }
+    const char * c_str() const { return text.c_str(); }
+    const std::string & str() const { return text; }
+
+    bool equals( const String & other ) const { return text == other.text; }
+    bool equals( const char * other ) const { return text == other; }
+    bool operator==( const String & other ) const { return text == other.text; }
+    bool operator!=( const String & other ) const { return text != other.text; }
+    bool startsWith( const String & prefix ) const { return text.compare( 0, prefix.text.size(), prefix.text ) == 0; }
+
+    int indexOf( char character, unsigned int from = 0 ) const
+    {
+        size_t position = text.find( character, from );
+
+        return position == std::string::npos ? -1 : (int) position;
+    }
+
+    int indexOf( const String & other ) const
+    {
+        size_t position = text.find( other.text );
+
+        return position == std::string::npos ? -1 : (int) position;
+    }
+
+    String substring( unsigned int begin ) const
+    {
+        return begin > text.size() ? String() : String( text.substr( begin ) );
+    }
+
+    String substring( unsigned int begin, unsigned int end ) const
+    {
+        if ( begin > end )
+        {
+            std::swap( begin, end );
+        }
+
+        return begin > text.size() ? String() : String( text.substr( begin, end - begin ) );
+    }
+
+    void remove( unsigned int index, unsigned int count = (unsigned int) -1 )
+    {
+        if ( index < text.size() )
+        {
+            text.erase( index, count );
+        }
+    }
+
+    void trim()
+    {
+        size_t begin = text.find_first_not_of( " \t\r\n" );
+
+        if ( begin == std::string::npos )
+        {
+            text.clear();
+
+            return;
+        }
+
+        text = text.substr( begin, text.find_last_not_of( " \t\r\n" ) - begin + 1 );
+    }
+
+    void toLowerCase()
+    {
+        for ( char & character : text )
+        {
+            character = tolower( character );
+        }
+    }
+
+    void toCharArray( char * buffer, unsigned int size ) const
+    {
+        if ( size == 0 )
+        {
+            return;
+        }
+
+        size_t length = text.size() < size ? text.size() : size - 1;
+        memcpy( buffer, text.data(), length );
+        buffer[length] = '\0';
+    }
+
+    char charAt( unsigned int index ) const { return index < text.size() ? text[index] : '\0'; }
+    char operator[]( unsigned int index ) const { return charAt( index ); }
+
+    void setCharAt( unsigned int index, char character )
+    {
+        if ( index < text.size() )
+        {
+            text[index] = character;
+        }
+    }
+
+    long toInt() const { return atol( text.c_str() ); }
+    float toFloat() const { return atof( text.c_str() ); }
+
+    unsigned char reserve( unsigned int size ) { text.reserve( size ); return 1; }
+    unsigned char concat( const String & other ) { text += other.text; return 1; }
+    unsigned char concat( char character ) { text += character; return 1; }
+    unsigned char concat( const char * data, unsigned int length ) { text.append( data, length ); return 1; }
+
+    String & operator+=( const String & other ) { text += other.text; return *this; }
+    String & operator+=( const char * other ) { text += other; return *this; }
+    String & operator+=( char character ) { text += character; return *this; }
+};
+
+inline String operator+( const String & a, const String & b ) { return String( a.str() + b.str() ); }
+inline String operator+( const String & a, const char * b ) { return String( a.str() + b ); }
+inline String operator+( const char * a, const String & b ) { return String( a + b.str() ); }
+inline String operator+( const String & a, char b ) { return String( a.str() + b ); }
+
+class Print
+{
+public:
+    virtual ~Print() {}
+
+    virtual size_t write( uint8_t character ) = 0;
+
+    virtual size_t write( const uint8_t * data, size_t length )
+    {
+        size_t written = 0;
+
+        while ( length-- > 0 )
+        {
+            written += write( *data++ );
+        }
+
+        return written;
+    }
+
+    size_t write( const char * text ) { return text != nullptr ? write( (const uint8_t *) text, strlen( text ) ) : 0; }
+    size_t write( const char * data, size_t length ) { return write( (const uint8_t *) data, length ); }
+
+    virtual int availableForWrite() { return 0; }
+    virtual void flush() {}
+
+    size_t print( const String & text ) { return write( (const uint8_t *) text.c_str(), text.length() ); }
+    size_t print( const char * text ) { return write( text ); }
+    size_t print( const __FlashStringHelper * text ) { return write( (const char *) text ); }
+    size_t print( char character ) { return write( (uint8_t) character ); }
+    size_t print( int value, int base = DEC ) { return print( String( (long) value, base ) ); }
+    size_t print( unsigned int value, int base = DEC ) { return print( String( (unsigned long) value, base ) ); }
+    size_t print( long value, int base = DEC ) { return print( String( value, base ) ); }
+    size_t print( unsigned long value, int base = DEC ) { return print( String( value, base ) ); }
+    size_t print( double value, int decimalPlaces = 2 ) { return print( String( value, decimalPlaces ) ); }
+
+    size_t println() { return write( "\r\n" ); }
+
+    template <typename T>
+    size_t println( const T & value ) { return print( value ) + println(); }
+
+    template <typename T>
+    size_t println( const T & value, int format ) { return print( value, format ) + println(); }
+};
+
+class Stream : public Print
+{
+protected:
+    unsigned long timeout = 1000;
+
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+
+    void setTimeout( unsigned long timeout ) { this->timeout = timeout; }
+    unsigned long getTimeout() { return this->timeout; }
+
+    virtual size_t readBytes( char * buffer, size_t length )
+    {
+        size_t count = 0;
+
+        while ( count < length )
+        {
+            int character = read();
+
+            if ( character < 0 )
+            {
+                break;
+            }
+
+            buffer[count++] = (char) character;
+        }
+
+        return count;
+    }
+
+    size_t readBytes( uint8_t * buffer, size_t length ) { return readBytes( (char *) buffer, length ); }
+
+    String readString()
+    {
+        String text;
+        int character;
+
+        while ( ( character = read() ) >= 0 )
+        {
+            text += (char) character;
+        }
+
+        return text;
+    }
+};
+
+// In-memory Stream: feed() queues bytes to be received, and everything written is appended to the output.
+// All accesses are locked, so feeding, receiving and writing may happen on different threads.
+class MockStream : public Stream
+{
+private:
+    std::mutex mutex;
+    std::deque<uint8_t> input;
+    std::string output;
+
+public:
+    int available() override
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+
+        return input.size();
+    }
+
+    int read() override
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+
+        if ( input.empty() )
+        {
+            return -1;
+        }
+
+        int character = input.front();
+        input.pop_front();
+
+        return character;
+    }
+
+    int peek() override
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+
+        return input.empty() ? -1 : input.front();
+    }
+
+    using Print::write;
+
+    size_t write( uint8_t character ) override
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        output += (char) character;
+
+        return 1;
+    }
+
+    void feed( const std::string & data )
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        input.insert( input.end(), data.begin(), data.end() );
+    }
+
+    // Returns everything written so far, and clears it.
+    std::string takeOutput()
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        std::string written;
+        written.swap( output );
+
+        return written;
+    }
+};
+
+extern MockStream Serial;
+
+#endif // ARDUINO_MOCK_H
@@ -0,0 +1,39 @@
+/*
+    Copyright 2019 Jan-Eric Schober
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#ifndef MESSAGETYPES_HPP
+#define MESSAGETYPES_HPP
+
+// Stands in for the MessageTypes library, which provides the names of the standard message types.
+
+// Arduino Standard Libraries
+#include <Arduino.h>
+
+namespace MessageType
+{
+    const String RESPONSE = "response";
+    const String INFO = "info";
+    const String ERROR = "error";
+    const String PING = "ping";
+    const String STATUS = "status";
+    const String ID = "id";
+    const String ACTIVE = "active";
+    const String ECHO = "echo";
+    const String COMMANDS = "commands";
+    const String COMMAND = "command";
+}
+
+#endif // MESSAGETYPES_HPP
@@ -0,0 +1,86 @@
+/*
+    Copyright 2019 Jan-Eric Schober
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#ifndef CODEC_HPP
+#define CODEC_HPP
+
+// Arduino Standard Libraries
+#include <Arduino.h>
+
+class StreamCommander;
+
+// Interface of the formats in which commands are received and messages are sent (see StreamCommander::setCodec()).
+// The command registry and callbacks are the same for every codec; only the format on the wire differs.
+class Codec
+{
+public:
+    // Destructor
+    virtual ~Codec() {}
+
+    // Gets the name, by which hosts select the codec with the mode-command.
+    virtual const char * getName() = 0;
+
+    // Returns whether the codec carries any bytes as they are. Otherwise, binary content gets encoded (see encodeBinaryMessage()),
+    // so binary protocols on top (e.g. the chunks of bulk transfers) rather fall back to a text format.
+    virtual bool isBinary() { return true; }
+
+    // Decodes received bytes, and passes every complete command on to the StreamCommander (see the helpers below).
+    // If a command switches the codec, the rest of the bytes has to be passed on to StreamCommander::receiveBytes().
+    virtual void decode( StreamCommander * instance, const char * data, int length ) = 0;
+
+    // Discards a partially decoded command, e.g. because the codec has been switched.
+    virtual void resetDecoder() {}
+
+    // Writes everything in front of the content of a message, whose content gets streamed afterwards.
+    // Returns false if the codec needs the whole content in advance (e.g. for its' length); the message then gets collected and passed to encodeMessage().
+    virtual bool encodeBegin( Print & output, byte messageTypeId, const String & header ) = 0;
+
+    // Writes everything behind the streamed content of a message.
+    virtual void encodeEnd( Print & output ) = 0;
+
+    // Encodes a complete message. The header (type + message delimiter) is always given;
+    // the message type ID is StreamCommander::UNREGISTERED_MESSAGE_TYPE for message types which haven't been registered.
+    virtual void encodeMessage( Print & output, byte messageTypeId, const String & header, const char * content, int length ) = 0;
+
+    // Encodes a complete message, whose content may contain any bytes (e.g. StreamCommander::sendTelemetry()).
+    // By default, the content gets passed to encodeMessage() as it is, which suits codecs that can carry any bytes.
+    virtual void encodeBinaryMessage( Print & output, byte messageTypeId, const String & header, const char * content, int length );
+
+    // Encodes a complete message, whose content is MessagePack (see StreamCommander::beginStructuredMessage()).
+    // By default, it gets encoded like any other binary content.
+    virtual void encodeStructuredMessage( Print & output, byte messageTypeId, const String & header, const char * content, int length );
+
+protected:
+    // Helpers for decoders, which all share the bounded receive buffer of the StreamCommander
+    // Appends bytes to the receive buffer, as far as the maximum line length allows. Returns the number of appended bytes.
+    static int appendToBuffer( StreamCommander * instance, const char * data, int length );
+
+    // Dispatches the command with the given ID (see the schema) and the receive buffer as arguments, and empties the buffer.
+    // Commands which didn't fit into the buffer get counted, and are handled according to the line overflow policy.
+    static void dispatchBuffer( StreamCommander * instance, byte commandId );
+
+    // Empties the receive buffer.
+    static void discardBuffer( StreamCommander * instance );
+
+    // Feeds bytes into the line-based receive state machine of the StreamCommander (line endings, command delimiter and fast commands).
+    static void receiveLines( StreamCommander * instance, const char * data, int length );
+
+    // Invokes the fast command with the given trigger byte. Returns false if there is none.
+    // Decoders should only match bytes which can't be part of a command, e.g. the ones skipped between two commands.
+    static bool matchFastCommand( StreamCommander * instance, char character );
+};
+
+#endif // CODEC_HPP
@@ -0,0 +1,417 @@
+/*
+    Copyright 2019 Jan-Eric Schober
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "Codecs.hpp"
+#include "StreamCommander.hpp"
+
+int Codec::appendToBuffer( StreamCommander * instance, const char * data, int length )
+{
+    return instance->appendToLine( data, length );
+}
+
+void Codec::dispatchBuffer( StreamCommander * instance, byte commandId )
+{
+    instance->dispatchCommandId( commandId );
+}
+
+void Codec::discardBuffer( StreamCommander * instance )
+{
+    instance->resetReceiveState();
+}
+
+void Codec::receiveLines( StreamCommander * instance, const char * data, int length )
+{
+    instance->receiveTextBytes( data, length );
+}
+
+bool Codec::matchFastCommand( StreamCommander * instance, char character )
+{
+    return instance->matchFastCommand( character );
+}
+
+void Codec::encodeBinaryMessage( Print & output, byte messageTypeId, const String & header, const char * content, int length )
+{
+    encodeMessage( output, messageTypeId, header, content, length );
+}
+
+void Codec::encodeStructuredMessage( Print & output, byte messageTypeId, const String & header, const char * content, int length )
+{
+    encodeBinaryMessage( output, messageTypeId, header, content, length );
+}
+
+const char * TextCodec::getName()
+{
+    return "text";
+}
+
+bool TextCodec::isBinary()
+{
+    return false;
+}
+
+void TextCodec::decode( StreamCommander * instance, const char * data, int length )
+{
+    // Lines share the receive state machine with fast commands and the incremental hashing of command names
+    receiveLines( instance, data, length );
+}
+
+bool TextCodec::encodeBegin( Print & output, byte messageTypeId, const String & header )
+{
+    output.print( header );
+
+    return true;
+}
+
+void TextCodec::encodeEnd( Print & output )
+{
+    output.println();
+}
+
+void TextCodec::encodeMessage( Print & output, byte messageTypeId, const String & header, const char * content, int length )
+{
+    // Write the parts one after another instead of concatenating them, so the content doesn't get copied again
+    output.print( header );
+    output.write( (const uint8_t *) content, length );
+    output.println();
+}
+
+void TextCodec::encodeBinaryMessage( Print & output, byte messageTypeId, const String & header, const char * content, int length )
+{
+    static const char HEX_DIGITS[] = "0123456789abcdef";
+
+    output.print( header );
+
+    for ( int i = 0; i < length; i++ )
+    {
+        output.write( HEX_DIGITS[(byte) content[i] >> 4] );
+        output.write( HEX_DIGITS[content[i] & 0x0F] );
+    }
+
+    output.println();
+}
+
+const char * BinaryCodec::getName()
+{
+    return "binary";
+}
+
+void BinaryCodec::decode( StreamCommander * instance, const char * data, int length )
+{
+    // Drop the rest of a frame which hasn't been completed in time, in order to get back in sync with the host
+    if ( ( frameLengthShift > 0 || frameLengthComplete ) && millis() - frameStartTime > (unsigned long) instance->getStreamBufferTimeout() )
+    {
+        resetDecoder();
+        discardBuffer( instance );
+    }
+
+    int position = 0;
+
+    while ( position < length )
+    {
+        // Every frame starts with its' length
+        if ( !frameLengthComplete )
+        {
+            byte lengthByte = data[position++];
+
+            if ( frameLengthShift == 0 )
+            {
+                frameStartTime = millis();
+            }
+
+            frameLength |= ( lengthByte & 0x7F ) << frameLengthShift;
+            frameLengthShift += 7;
+
+            if ( lengthByte & 0x80 )
+            {
+                // Lengths which don't fit into LENGTH_MAX_BYTES can't be valid
+                if ( frameLengthShift >= LENGTH_MAX_BYTES * 7 )
+                {
+                    resetDecoder();
+                }
+
+                continue;
+            }
+
+            frameLengthComplete = frameLength > 0;
+
+            if ( !frameLengthComplete )
+            {
+                resetDecoder();
+            }
+
+            continue;
+        }
+
+        // The first byte is the command ID, which doesn't take up space in the receive buffer
+        if ( frameReceived == 0 )
+        {
+            commandId = data[position++];
+            frameReceived = 1;
+        }
+
+        // Append as much of the frame as is available at once
+        int received = min( frameLength - frameReceived, length - position );
+        appendToBuffer( instance, data + position, received );
+        frameReceived += received;
+        position += received;
+
+        if ( frameReceived < frameLength )
+        {
+            break;
+        }
+
+        resetDecoder();
+        dispatchBuffer( instance, commandId );
+
+        // The command might have switched the codec, which applies to the rest of the bytes already
+        if ( instance->getCodec() != this )
+        {
+            instance->receiveBytes( data + position, length - position );
+
+            return;
+        }
+    }
+}
+
+void BinaryCodec::resetDecoder()
+{
+    frameLength = 0;
+    frameReceived = 0;
+    frameLengthShift = 0;
+    frameLengthComplete = false;
+}
+
+bool BinaryCodec::encodeBegin( Print & output, byte messageTypeId, const String & header )
+{
+    // Frames start with their length, so the content has to be collected first
+    return false;
+}
+
+void BinaryCodec::encodeEnd( Print & output )
+{
+}
+
+void BinaryCodec::encodeMessage( Print & output, byte messageTypeId, const String & header, const char * content, int length )
+{
+    // Only messages of unregistered types need their header, since the ID doesn't identify them
+    int headerLength = messageTypeId == StreamCommander::UNREGISTERED_MESSAGE_TYPE ? header.length() : 0;
+
+    writeVarint( output, 1 + headerLength + length );
+    output.write( messageTypeId );
+    output.write( (const uint8_t *) header.c_str(), headerLength );
+    output.write( (const uint8_t *) content, length );
+}
+
+int BinaryCodec::writeVarint( Print & output, unsigned long value )
+{
+    int numBytes = 1;
+
+    while ( value >= 0x80 )
+    {
+        output.write( (uint8_t) ( ( value & 0x7F ) | 0x80 ) );
+        value >>= 7;
+        numBytes++;
+    }
+
+    output.write( (uint8_t) value );
+
+    return numBytes;
+}
+
+const char * MessagePackCodec::getName()
+{
+    return "msgpack";
+}
+
+void MessagePackCodec::decode( StreamCommander * instance, const char * data, int length )
+{
+    // Drop the rest of a command which hasn't been completed in time, in order to get back in sync with the host
+    if ( decoderState != DECODE_ARRAY && millis() - commandStartTime > (unsigned long) instance->getStreamBufferTimeout() )
+    {
+        resetDecoder();
+        discardBuffer( instance );
+    }
+
+    int position = 0;
+
+    while ( position < length )
+    {
+        // Arguments get appended as a whole run, as far as they are available
+        if ( decoderState == DECODE_ARGUMENTS_CONTENT )
+        {
+            int received = min( (int) remaining, length - position );
+            appendToBuffer( instance, data + position, received );
+            remaining -= received;
+            position += received;
+
+            if ( remaining == 0 )
+            {
+                finishCommand( instance );
+            }
+        }
+        else
+        {
+            byte character = data[position++];
+
+            if ( decoderState == DECODE_ARRAY )
+            {
+                // Everything but a fixarray of one or two elements gets skipped until the next command starts, so fast command triggers can be matched there
+                if ( character == 0x91 || character == 0x92 )
+                {
+                    numElements = character & 0x0F;
+                    commandStartTime = millis();
+                    decoderState = DECODE_COMMAND;
+                }
+                else
+                {
+                    matchFastCommand( instance, character );
+                }
+            }
+            else if ( decoderState == DECODE_COMMAND )
+            {
+                // Positive fixint, or uint8 followed by the ID
+                if ( character < 0x80 )
+                {
+                    commandId = character;
+                    decoderState = DECODE_ARGUMENTS;
+                }
+                else if ( character == 0xCC )
+                {
+                    decoderState = DECODE_COMMAND_ID;
+                }
+                else
+                {
+                    resetDecoder();
+                }
+            }
+            else if ( decoderState == DECODE_COMMAND_ID )
+            {
+                commandId = character;
+                decoderState = DECODE_ARGUMENTS;
+            }
+            else if ( decoderState == DECODE_ARGUMENTS )
+            {
+                // Nil, fixstr, str 8/16 or bin 8/16
+                if ( character == 0xC0 )
+                {
+                    finishCommand( instance );
+                }
+                else if ( ( character & 0xE0 ) == 0xA0 )
+                {
+                    remaining = character & 0x1F;
+                    decoderState = DECODE_ARGUMENTS_CONTENT;
+                }
+                else if ( character == 0xD9 || character == 0xC4 || character == 0xDA || character == 0xC5 )
+                {
+                    numLengthBytes = character == 0xD9 || character == 0xC4 ? 1 : 2;
+                    remaining = 0;
+                    decoderState = DECODE_ARGUMENTS_LENGTH;
+                }
+                else
+                {
+                    resetDecoder();
+                    discardBuffer( instance );
+                }
+            }
+            else if ( decoderState == DECODE_ARGUMENTS_LENGTH )
+            {
+                // Lengths are big endian
+                remaining = ( remaining << 8 ) | character;
+                numLengthBytes--;
+
+                if ( numLengthBytes == 0 )
+                {
+                    decoderState = DECODE_ARGUMENTS_CONTENT;
+                }
+            }
+
+            // Commands without arguments are complete right after their ID, empty arguments right after their length
+            if ( ( decoderState == DECODE_ARGUMENTS && numElements == 1 ) || ( decoderState == DECODE_ARGUMENTS_CONTENT && remaining == 0 ) )
+            {
+                finishCommand( instance );
+            }
+        }
+
+        // The command might have switched the codec, which applies to the rest of the bytes already
+        if ( decoderState == DECODE_ARRAY && instance->getCodec() != this )
+        {
+            instance->receiveBytes( data + position, length - position );
+
+            return;
+        }
+    }
+}
+
+void MessagePackCodec::finishCommand( StreamCommander * instance )
+{
+    resetDecoder();
+    dispatchBuffer( instance, commandId );
+}
+
+void MessagePackCodec::resetDecoder()
+{
+    decoderState = DECODE_ARRAY;
+    numElements = 0;
+    numLengthBytes = 0;
+    remaining = 0;
+}
+
+bool MessagePackCodec::encodeBegin( Print & output, byte messageTypeId, const String & header )
+{
+    // Strings start with their length, so the content has to be collected first
+    return false;
+}
+
+void MessagePackCodec::encodeEnd( Print & output )
+{
+}
+
+void MessagePackCodec::encodeMessage( Print & output, byte messageTypeId, const String & header, const char * content, int length )
+{
+    MessagePackWriter writer( output );
+    writer.beginArray( 2 );
+    writeMessageType( writer, messageTypeId, header );
+    writer.writeString( content, length );
+}
+
+void MessagePackCodec::encodeBinaryMessage( Print & output, byte messageTypeId, const String & header, const char * content, int length )
+{
+    MessagePackWriter writer( output );
+    writer.beginArray( 2 );
+    writeMessageType( writer, messageTypeId, header );
+    writer.writeBinary( (const uint8_t *) content, length );
+}
+
+void MessagePackCodec::encodeStructuredMessage( Print & output, byte messageTypeId, const String & header, const char * content, int length )
+{
+    MessagePackWriter writer( output );
+    writer.beginArray( 2 );
+    writeMessageType( writer, messageTypeId, header );
+    output.write( (const uint8_t *) content, length );
+}
+
+void MessagePackCodec::writeMessageType( MessagePackWriter & writer, byte messageTypeId, const String & header )
+{
+    if ( messageTypeId == StreamCommander::UNREGISTERED_MESSAGE_TYPE )
+    {
+        // The type without its' message delimiter
+        writer.writeString( header.c_str(), header.length() > 0 ? header.length() - 1 : 0 );
+
+        return;
+    }
+
+    writer.writeInt( messageTypeId );
+}
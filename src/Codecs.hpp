@@ -0,0 +1,116 @@
+/*
+    Copyright 2019 Jan-Eric Schober
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#ifndef CODECS_HPP
+#define CODECS_HPP
+
+// Arduino Standard Libraries
+#include <Arduino.h>
+
+#include "Codec.hpp"
+#include "MessagePackWriter.hpp"
+
+// Human-readable lines: "<command> <arguments>" and "<type>:<content>".
+class TextCodec : public Codec
+{
+public:
+    const char * getName();
+    bool isBinary();
+    void decode( StreamCommander * instance, const char * data, int length );
+    bool encodeBegin( Print & output, byte messageTypeId, const String & header );
+    void encodeEnd( Print & output );
+    void encodeMessage( Print & output, byte messageTypeId, const String & header, const char * content, int length );
+
+    // Binary content (and MessagePack) gets sent as hex digits, since it may contain line endings.
+    void encodeBinaryMessage( Print & output, byte messageTypeId, const String & header, const char * content, int length );
+};
+
+// Length-prefixed frames: "<length><command ID><arguments>" and "<length><message type ID><content>".
+// The length is a varint (7 bits per byte, least significant first, the highest bit is set if another byte follows).
+// Messages of unregistered types have the ID StreamCommander::UNREGISTERED_MESSAGE_TYPE, and contain "<type>:<content>".
+class BinaryCodec : public Codec
+{
+private:
+    // Constants
+    static const int LENGTH_MAX_BYTES = 2;
+
+    // Variables
+    int frameLength = 0;
+    int frameReceived = 0;
+    byte frameLengthShift = 0;
+    bool frameLengthComplete = false;
+    unsigned long frameStartTime = 0;
+    byte commandId = 0;
+
+public:
+    const char * getName();
+    void decode( StreamCommander * instance, const char * data, int length );
+    void resetDecoder();
+    bool encodeBegin( Print & output, byte messageTypeId, const String & header );
+    void encodeEnd( Print & output );
+    void encodeMessage( Print & output, byte messageTypeId, const String & header, const char * content, int length );
+
+    // Writes a varint. Returns the number of written bytes.
+    static int writeVarint( Print & output, unsigned long value );
+};
+
+// MessagePack arrays: [<command ID>, "<arguments>"] and [<message type ID>, "<content>"].
+// The arguments may also be nil or left out; messages of unregistered types have their type as string instead of the ID.
+class MessagePackCodec : public Codec
+{
+private:
+    // Enums
+    enum DecoderState
+    {
+        DECODE_ARRAY,
+        DECODE_COMMAND,
+        DECODE_COMMAND_ID,
+        DECODE_ARGUMENTS,
+        DECODE_ARGUMENTS_LENGTH,
+        DECODE_ARGUMENTS_CONTENT
+    };
+
+    // Variables
+    DecoderState decoderState = DECODE_ARRAY;
+    byte numElements = 0;
+    byte commandId = 0;
+    byte numLengthBytes = 0;
+    unsigned int remaining = 0; // Length of the arguments, or the remaining bytes of them
+    unsigned long commandStartTime = 0;
+
+    // Private Methods
+    // Dispatches the decoded command, and starts over with the next one.
+    void finishCommand( StreamCommander * instance );
+
+public:
+    const char * getName();
+    void decode( StreamCommander * instance, const char * data, int length );
+    void resetDecoder();
+    bool encodeBegin( Print & output, byte messageTypeId, const String & header );
+    void encodeEnd( Print & output );
+    void encodeMessage( Print & output, byte messageTypeId, const String & header, const char * content, int length );
+
+    // Binary content gets sent as bin instead of as a string.
+    void encodeBinaryMessage( Print & output, byte messageTypeId, const String & header, const char * content, int length );
+
+    // MessagePack content gets embedded as it is, instead of as a string: [<message type ID>, <content>].
+    void encodeStructuredMessage( Print & output, byte messageTypeId, const String & header, const char * content, int length );
+
+    // Writes the message type: its' ID, or the type itself as string for messages of unregistered types.
+    static void writeMessageType( MessagePackWriter & writer, byte messageTypeId, const String & header );
+};
+
+#endif // CODECS_HPP
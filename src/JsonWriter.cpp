@@ -0,0 +1,222 @@
+/*
+    Copyright 2019 Jan-Eric Schober
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "JsonWriter.hpp"
+#include "StreamCommander.hpp"
+
+JsonWriter::JsonWriter( Print & output )
+{
+    reset( output );
+}
+
+void JsonWriter::reset( Print & output )
+{
+    this->output = &output;
+    this->depth = 0;
+    this->nonEmpty = 0;
+    this->afterKey = false;
+}
+
+void JsonWriter::beginValue()
+{
+    if ( afterKey )
+    {
+        afterKey = false;
+
+        return;
+    }
+
+    uint32_t bit = (uint32_t) 1 << ( depth % MAX_DEPTH );
+
+    if ( depth > 0 && ( nonEmpty & bit ) )
+    {
+        output->write( ',' );
+    }
+
+    nonEmpty |= bit;
+}
+
+void JsonWriter::writeQuoted( const char * value, unsigned int length )
+{
+    static const char HEX_DIGITS[] = "0123456789abcdef";
+
+    output->write( '"' );
+
+    unsigned int runStart = 0;
+
+    for ( unsigned int i = 0; i < length; i++ )
+    {
+        byte character = value[i];
+
+        if ( character >= 0x20 && character != '"' && character != '\\' )
+        {
+            continue;
+        }
+
+        // Write the run of regular characters at once, followed by the escaped one
+        output->write( (const uint8_t *) value + runStart, i - runStart );
+        runStart = i + 1;
+
+        output->write( '\\' );
+
+        if ( character == '"' || character == '\\' )
+        {
+            output->write( character );
+        }
+        else if ( character == '\n' )
+        {
+            output->write( 'n' );
+        }
+        else if ( character == '\r' )
+        {
+            output->write( 'r' );
+        }
+        else if ( character == '\t' )
+        {
+            output->write( 't' );
+        }
+        else
+        {
+            output->print( "u00" );
+            output->write( HEX_DIGITS[character >> 4] );
+            output->write( HEX_DIGITS[character & 0x0F] );
+        }
+    }
+
+    output->write( (const uint8_t *) value + runStart, length - runStart );
+    output->write( '"' );
+}
+
+void JsonWriter::beginObject()
+{
+    beginValue();
+    output->write( '{' );
+    depth++;
+    nonEmpty &= ~( (uint32_t) 1 << ( depth % MAX_DEPTH ) );
+}
+
+void JsonWriter::endObject()
+{
+    depth--;
+    output->write( '}' );
+}
+
+void JsonWriter::beginArray()
+{
+    beginValue();
+    output->write( '[' );
+    depth++;
+    nonEmpty &= ~( (uint32_t) 1 << ( depth % MAX_DEPTH ) );
+}
+
+void JsonWriter::endArray()
+{
+    depth--;
+    output->write( ']' );
+}
+
+void JsonWriter::writeKey( const char * key )
+{
+    beginValue();
+    writeQuoted( key, strlen( key ) );
+    output->write( ':' );
+    afterKey = true;
+}
+
+void JsonWriter::writeKey( const String & key )
+{
+    beginValue();
+    writeQuoted( key.c_str(), key.length() );
+    output->write( ':' );
+    afterKey = true;
+}
+
+void JsonWriter::writeString( const char * value )
+{
+    writeString( value, strlen( value ) );
+}
+
+void JsonWriter::writeString( const char * value, unsigned int length )
+{
+    beginValue();
+    writeQuoted( value, length );
+}
+
+void JsonWriter::writeString( const String & value )
+{
+    writeString( value.c_str(), value.length() );
+}
+
+void JsonWriter::writeInt( int value )
+{
+    beginValue();
+    output->print( value );
+}
+
+void JsonWriter::writeInt( unsigned int value )
+{
+    beginValue();
+    output->print( value );
+}
+
+void JsonWriter::writeInt( long value )
+{
+    beginValue();
+    output->print( value );
+}
+
+void JsonWriter::writeInt( unsigned long value )
+{
+    beginValue();
+    output->print( value );
+}
+
+void JsonWriter::writeFloat( double value, byte decimals )
+{
+    // JSON has no representation of NaN and infinity, the only values for which value - value isn't 0
+    if ( !( value - value == 0 ) )
+    {
+        writeNull();
+
+        return;
+    }
+
+    beginValue();
+
+    // Print only handles numbers up to 32 bits (and prints "ovf" beyond), so larger ones get formatted like numeric statuses,
+    // which switches to scientific notation (e.g. 1.00e30) where String would overflow the buffer of dtostrf() on some cores
+    if ( fabs( value ) >= 4294967040.0 )
+    {
+        char buffer[StreamCommander::NUMBER_BUFFER_SIZE];
+        output->write( buffer, StreamCommander::formatNumber( buffer, value, decimals ) );
+
+        return;
+    }
+
+    output->print( value, decimals );
+}
+
+void JsonWriter::writeBool( bool value )
+{
+    beginValue();
+    output->print( value ? "true" : "false" );
+}
+
+void JsonWriter::writeNull()
+{
+    beginValue();
+    output->print( "null" );
+}
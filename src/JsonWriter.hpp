@@ -0,0 +1,89 @@
+/*
+    Copyright 2019 Jan-Eric Schober
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#ifndef JSONWRITER_HPP
+#define JSONWRITER_HPP
+
+// Arduino Standard Libraries
+#include <Arduino.h>
+
+// Writes JSON straight to a Print, value by value, without building the document or any strings in memory.
+// Commas between values are inserted automatically; strings get escaped. Only the nesting needs to be kept track of (up to MAX_DEPTH levels).
+class JsonWriter
+{
+private:
+    // Constants
+    static const byte MAX_DEPTH = 32;
+
+    // Variables
+    Print * output;
+    byte depth = 0;
+    uint32_t nonEmpty = 0; // Bit per nesting level, which is set once a value has been written at that level
+    bool afterKey = false;
+
+    // Private Methods
+    // Writes the comma in front of a value, unless it's the first one of its' object/array or follows a key.
+    void beginValue();
+
+    // Writes a string in quotes, with all special characters escaped.
+    void writeQuoted( const char * value, unsigned int length );
+
+public:
+    // Constructor
+    JsonWriter( Print & output );
+
+    // Starts a new document on the given Print.
+    void reset( Print & output );
+
+    // Starts an object, whose members are written as writeKey() followed by a value.
+    void beginObject();
+
+    // Terminates an object.
+    void endObject();
+
+    // Starts an array.
+    void beginArray();
+
+    // Terminates an array.
+    void endArray();
+
+    // Writes the key of an object member, which has to be followed by its' value.
+    void writeKey( const char * key );
+    void writeKey( const String & key );
+
+    // Writes a string.
+    void writeString( const char * value );
+    void writeString( const char * value, unsigned int length );
+    void writeString( const String & value );
+
+    // Writes an integer.
+    void writeInt( int value );
+    void writeInt( unsigned int value );
+    void writeInt( long value );
+    void writeInt( unsigned long value );
+
+    // Writes a floating-point number with the given number of decimals; NaN and infinity are written as null.
+    // Numbers beyond 32 bits take up to 6 decimals, and those which are too large for a 64 bit fixed-point number are written in scientific notation (e.g. 1.00e30).
+    void writeFloat( double value, byte decimals = 2 );
+
+    // Writes a boolean.
+    void writeBool( bool value );
+
+    // Writes null.
+    void writeNull();
+};
+
+#endif // JSONWRITER_HPP
@@ -0,0 +1,273 @@
+/*
+    Copyright 2019 Jan-Eric Schober
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "MessagePackWriter.hpp"
+
+MessagePackWriter::MessagePackWriter( Print & output )
+{
+    this->output = &output;
+}
+
+void MessagePackWriter::writeBigEndian( uint32_t value, byte numBytes )
+{
+    for ( int shift = ( numBytes - 1 ) * 8; shift >= 0; shift -= 8 )
+    {
+        output->write( (uint8_t) ( value >> shift ) );
+    }
+}
+
+void MessagePackWriter::writeNil()
+{
+    output->write( (uint8_t) 0xC0 );
+}
+
+void MessagePackWriter::writeBool( bool value )
+{
+    output->write( (uint8_t) ( value ? 0xC3 : 0xC2 ) );
+}
+
+void MessagePackWriter::writeInt( int value )
+{
+    writeSigned( value );
+}
+
+void MessagePackWriter::writeInt( unsigned int value )
+{
+    writeUnsigned( value );
+}
+
+void MessagePackWriter::writeInt( long value )
+{
+    writeInt( (long long) value );
+}
+
+void MessagePackWriter::writeInt( unsigned long value )
+{
+    writeInt( (unsigned long long) value );
+}
+
+void MessagePackWriter::writeInt( long long value )
+{
+    if ( value >= INT32_MIN && value <= INT32_MAX )
+    {
+        writeSigned( (int32_t) value );
+
+        return;
+    }
+
+    if ( value > 0 )
+    {
+        writeInt( (unsigned long long) value );
+
+        return;
+    }
+
+    output->write( (uint8_t) 0xD3 );
+    writeBigEndian( (uint32_t) ( (uint64_t) value >> 32 ), 4 );
+    writeBigEndian( (uint32_t) value, 4 );
+}
+
+void MessagePackWriter::writeInt( unsigned long long value )
+{
+    if ( value <= UINT32_MAX )
+    {
+        writeUnsigned( (uint32_t) value );
+
+        return;
+    }
+
+    output->write( (uint8_t) 0xCF );
+    writeBigEndian( (uint32_t) ( value >> 32 ), 4 );
+    writeBigEndian( (uint32_t) value, 4 );
+}
+
+void MessagePackWriter::writeSigned( int32_t value )
+{
+    if ( value >= 0 )
+    {
+        writeUnsigned( (uint32_t) value );
+    }
+    else if ( value >= -32 )
+    {
+        // Negative fixint
+        output->write( (uint8_t) value );
+    }
+    else if ( value >= -128 )
+    {
+        output->write( (uint8_t) 0xD0 );
+        writeBigEndian( value, 1 );
+    }
+    else if ( value >= -32768 )
+    {
+        output->write( (uint8_t) 0xD1 );
+        writeBigEndian( value, 2 );
+    }
+    else
+    {
+        output->write( (uint8_t) 0xD2 );
+        writeBigEndian( value, 4 );
+    }
+}
+
+void MessagePackWriter::writeUnsigned( uint32_t value )
+{
+    if ( value < 0x80 )
+    {
+        // Positive fixint
+        output->write( (uint8_t) value );
+    }
+    else if ( value < 0x100 )
+    {
+        output->write( (uint8_t) 0xCC );
+        writeBigEndian( value, 1 );
+    }
+    else if ( value < 0x10000 )
+    {
+        output->write( (uint8_t) 0xCD );
+        writeBigEndian( value, 2 );
+    }
+    else
+    {
+        output->write( (uint8_t) 0xCE );
+        writeBigEndian( value, 4 );
+    }
+}
+
+void MessagePackWriter::writeFloat( float value )
+{
+    uint32_t bits;
+    memcpy( &bits, &value, sizeof( bits ) );
+
+    output->write( (uint8_t) 0xCA );
+    writeBigEndian( bits, 4 );
+}
+
+void MessagePackWriter::writeDouble( double value )
+{
+    // On AVR, double is the same as float
+    if ( sizeof( double ) == sizeof( float ) )
+    {
+        writeFloat( value );
+
+        return;
+    }
+
+    uint64_t bits;
+    memcpy( &bits, &value, sizeof( bits ) );
+
+    output->write( (uint8_t) 0xCB );
+    writeBigEndian( (uint32_t) ( bits >> 32 ), 4 );
+    writeBigEndian( (uint32_t) bits, 4 );
+}
+
+void MessagePackWriter::writeString( const char * value )
+{
+    writeString( value, strlen( value ) );
+}
+
+void MessagePackWriter::writeString( const char * value, unsigned int length )
+{
+    writeStringHeader( length );
+    output->write( (const uint8_t *) value, length );
+}
+
+void MessagePackWriter::writeString( const String & value )
+{
+    writeString( value.c_str(), value.length() );
+}
+
+void MessagePackWriter::writeStringHeader( uint32_t length )
+{
+    if ( length < 32 )
+    {
+        // Fixstr
+        output->write( (uint8_t) ( 0xA0 | length ) );
+    }
+    else if ( length < 0x100 )
+    {
+        output->write( (uint8_t) 0xD9 );
+        writeBigEndian( length, 1 );
+    }
+    else if ( length < 0x10000 )
+    {
+        output->write( (uint8_t) 0xDA );
+        writeBigEndian( length, 2 );
+    }
+    else
+    {
+        output->write( (uint8_t) 0xDB );
+        writeBigEndian( length, 4 );
+    }
+}
+
+void MessagePackWriter::writeBinary( const uint8_t * value, unsigned int length )
+{
+    if ( length < 0x100 )
+    {
+        output->write( (uint8_t) 0xC4 );
+        writeBigEndian( length, 1 );
+    }
+    else if ( length < 0x10000 )
+    {
+        output->write( (uint8_t) 0xC5 );
+        writeBigEndian( length, 2 );
+    }
+    else
+    {
+        output->write( (uint8_t) 0xC6 );
+        writeBigEndian( length, 4 );
+    }
+
+    output->write( value, length );
+}
+
+void MessagePackWriter::beginArray( uint32_t numElements )
+{
+    if ( numElements < 16 )
+    {
+        // Fixarray
+        output->write( (uint8_t) ( 0x90 | numElements ) );
+    }
+    else if ( numElements < 0x10000 )
+    {
+        output->write( (uint8_t) 0xDC );
+        writeBigEndian( numElements, 2 );
+    }
+    else
+    {
+        output->write( (uint8_t) 0xDD );
+        writeBigEndian( numElements, 4 );
+    }
+}
+
+void MessagePackWriter::beginMap( uint32_t numPairs )
+{
+    if ( numPairs < 16 )
+    {
+        // Fixmap
+        output->write( (uint8_t) ( 0x80 | numPairs ) );
+    }
+    else if ( numPairs < 0x10000 )
+    {
+        output->write( (uint8_t) 0xDE );
+        writeBigEndian( numPairs, 2 );
+    }
+    else
+    {
+        output->write( (uint8_t) 0xDF );
+        writeBigEndian( numPairs, 4 );
+    }
+}
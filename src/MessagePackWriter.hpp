@@ -0,0 +1,82 @@
+/*
+    Copyright 2019 Jan-Eric Schober
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#ifndef MESSAGEPACKWRITER_HPP
+#define MESSAGEPACKWRITER_HPP
+
+// Arduino Standard Libraries
+#include <Arduino.h>
+
+// Writes MessagePack values straight to a Print, one after another, without building any objects in memory.
+// Arrays and maps only write their number of elements; the elements (or key/value pairs) have to be written afterwards.
+// Every value is written in its' shortest form, so hosts can decode it with any MessagePack library.
+class MessagePackWriter
+{
+private:
+    // Variables
+    Print * output;
+
+    // Private Methods
+    // Writes the lowest bytes of a value, most significant first.
+    void writeBigEndian( uint32_t value, byte numBytes );
+
+    // Write integers which fit into 32 bits, without 64 bit arithmetics.
+    void writeSigned( int32_t value );
+    void writeUnsigned( uint32_t value );
+
+public:
+    // Constructor
+    MessagePackWriter( Print & output );
+
+    // Writes nil.
+    void writeNil();
+
+    // Writes a boolean.
+    void writeBool( bool value );
+
+    // Writes an integer.
+    void writeInt( int value );
+    void writeInt( unsigned int value );
+    void writeInt( long value );
+    void writeInt( unsigned long value );
+    void writeInt( long long value );
+    void writeInt( unsigned long long value );
+
+    // Writes a floating-point number (float 32).
+    void writeFloat( float value );
+
+    // Writes a floating-point number (float 64, or float 32 on boards where double only has 32 bits).
+    void writeDouble( double value );
+
+    // Writes a string.
+    void writeString( const char * value );
+    void writeString( const char * value, unsigned int length );
+    void writeString( const String & value );
+
+    // Writes the header of a string, whose content has to be written to the Print afterwards.
+    void writeStringHeader( uint32_t length );
+
+    // Writes binary data.
+    void writeBinary( const uint8_t * value, unsigned int length );
+
+    // Starts an array of the given number of elements.
+    void beginArray( uint32_t numElements );
+
+    // Starts a map of the given number of key/value pairs.
+    void beginMap( uint32_t numPairs );
+};
+
+#endif // MESSAGEPACKWRITER_HPP
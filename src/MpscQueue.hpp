@@ -0,0 +1,200 @@
+/*
+    Copyright 2019 Jan-Eric Schober
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#ifndef MPSCQUEUE_HPP
+#define MPSCQUEUE_HPP
+
+// Arduino Standard Libraries
+#include <Arduino.h>
+
+// Lock-free, fixed-size queue for any number of producers and exactly one consumer, which may run on different cores, tasks or in an interrupt.
+// Producers claim a slot by advancing the shared tail with compare-and-swap, and publish it by advancing the sequence number of that slot,
+// so a producer never waits for the consumer or for another producer which is still filling its' slot.
+// Slots are written and read in place: a producer fills the slot returned by reserve() and publishes it with push(),
+// the consumer reads the slot returned by front() and releases it with pop().
+template <typename T, unsigned int SIZE>
+class MpscQueue
+{
+private:
+    static_assert( SIZE > 1 && ( SIZE & ( SIZE - 1 ) ) == 0, "MpscQueue size has to be a power of two." );
+
+    // Structs
+    struct Slot
+    {
+        T value;
+        unsigned int sequence; // Equals the position the slot is free for, or that position + 1 once it has been published.
+    };
+
+    // Variables
+    Slot slots[SIZE];
+    unsigned int head = 0; // Next position to be read; only written by the consumer.
+    unsigned int tail = 0; // Next position to be claimed; shared by all producers.
+    unsigned int numDropped = 0; // Number of failed reserve() calls; shared by all producers.
+
+    // Private Methods
+    // Loads a value which has been published by another side.
+    static unsigned int load( const unsigned int * value )
+    {
+        #if defined( __AVR__ )
+        // Single core, but 16 bit accesses aren't atomic, so an interrupt must not get in between
+        uint8_t oldSREG = SREG;
+        cli();
+        unsigned int result = *(const volatile unsigned int *) value;
+        SREG = oldSREG;
+
+        return result;
+        #else
+        return __atomic_load_n( value, __ATOMIC_ACQUIRE );
+        #endif
+    }
+
+    // Publishes a value to the other sides, after all preceding writes.
+    static void store( unsigned int * value, unsigned int newValue )
+    {
+        #if defined( __AVR__ )
+        uint8_t oldSREG = SREG;
+        cli();
+        *(volatile unsigned int *) value = newValue;
+        SREG = oldSREG;
+        #else
+        __atomic_store_n( value, newValue, __ATOMIC_RELEASE );
+        #endif
+    }
+
+    // Sets a value to a new one, but only if it still equals the expected one. Otherwise, the expected value gets updated.
+    static bool compareExchange( unsigned int * value, unsigned int * expected, unsigned int newValue )
+    {
+        #if defined( __AVR__ )
+        uint8_t oldSREG = SREG;
+        cli();
+        bool exchanged = *(volatile unsigned int *) value == *expected;
+
+        if ( exchanged )
+        {
+            *(volatile unsigned int *) value = newValue;
+        }
+        else
+        {
+            *expected = *(volatile unsigned int *) value;
+        }
+
+        SREG = oldSREG;
+
+        return exchanged;
+        #else
+        return __atomic_compare_exchange_n( value, expected, newValue, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE );
+        #endif
+    }
+
+    // Increments a value shared by several sides.
+    static void increment( unsigned int * value )
+    {
+        #if defined( __AVR__ )
+        uint8_t oldSREG = SREG;
+        cli();
+        ( *(volatile unsigned int *) value )++;
+        SREG = oldSREG;
+        #else
+        __atomic_fetch_add( value, 1, __ATOMIC_RELAXED );
+        #endif
+    }
+
+public:
+    // Constructor
+    MpscQueue()
+    {
+        for ( unsigned int i = 0; i < SIZE; i++ )
+        {
+            slots[i].sequence = i;
+        }
+    }
+
+    // Producer: Claims the slot to be written next, or returns nullptr if the queue is full (which gets counted as a dropped element).
+    T * reserve()
+    {
+        unsigned int position = load( &tail );
+
+        while ( true )
+        {
+            Slot & slot = slots[position % SIZE];
+            int difference = (int) ( load( &slot.sequence ) - position );
+
+            if ( difference == 0 )
+            {
+                // The slot is free; claim it, unless another producer has been faster
+                if ( compareExchange( &tail, &position, position + 1 ) )
+                {
+                    return &slot.value;
+                }
+            }
+            else if ( difference < 0 )
+            {
+                // The slot still holds an element from the previous round, which hasn't been consumed yet
+                increment( &numDropped );
+
+                return nullptr;
+            }
+            else
+            {
+                // Another producer has claimed this position in the meantime
+                position = load( &tail );
+            }
+        }
+    }
+
+    // Producer: Publishes the slot returned by reserve() to the consumer.
+    void push( T * value )
+    {
+        // Find the slot which holds the value
+        Slot & slot = slots[( (char *) value - (char *) &slots[0].value ) / sizeof( Slot )];
+
+        store( &slot.sequence, slot.sequence + 1 );
+    }
+
+    // Consumer: Returns the oldest slot, or nullptr if the queue is empty or the oldest slot hasn't been published yet.
+    T * front()
+    {
+        Slot & slot = slots[head % SIZE];
+
+        if ( load( &slot.sequence ) != head + 1 )
+        {
+            return nullptr;
+        }
+
+        return &slot.value;
+    }
+
+    // Consumer: Releases the slot returned by front() to the producers.
+    void pop()
+    {
+        store( &slots[head % SIZE].sequence, head + SIZE );
+        head++;
+    }
+
+    // Gets the number of dropped elements.
+    unsigned int getNumDropped()
+    {
+        return load( &numDropped );
+    }
+
+    // Gets the number of claimed elements. Only a snapshot, if other sides are running concurrently.
+    int getLength()
+    {
+        return load( &tail ) - head;
+    }
+};
+
+#endif // MPSCQUEUE_HPP
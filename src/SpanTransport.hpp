@@ -0,0 +1,39 @@
+/*
+    Copyright 2019 Jan-Eric Schober
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#ifndef SPANTRANSPORT_HPP
+#define SPANTRANSPORT_HPP
+
+// Arduino Standard Libraries
+#include <Arduino.h>
+
+// Optional interface for receive drivers which keep received bytes in contiguous memory (e.g. a DMA ring buffer).
+// Instead of copying every byte out of the driver via Stream::read()/readBytes(), the StreamCommander scans the bytes right where they are.
+class SpanTransport
+{
+public:
+    // Destructor
+    virtual ~SpanTransport() {}
+
+    // Returns a pointer to the oldest received bytes, which have not been consumed yet, and sets length to the number of contiguous bytes there.
+    // Returns nullptr (or sets length to 0) if nothing has been received. For a ring buffer, this is the part up to the end of the buffer.
+    virtual const char * peekSpan( int & length ) = 0;
+
+    // Releases the given number of bytes from the beginning of the span returned by peekSpan().
+    virtual void consumeSpan( int length ) = 0;
+};
+
+#endif // SPANTRANSPORT_HPP
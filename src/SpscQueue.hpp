@@ -0,0 +1,132 @@
+/*
+    Copyright 2019 Jan-Eric Schober
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#ifndef SPSCQUEUE_HPP
+#define SPSCQUEUE_HPP
+
+// Arduino Standard Libraries
+#include <Arduino.h>
+
+// Lock-free, fixed-size queue for exactly one producer and one consumer, which may run on different cores, tasks or in an interrupt.
+// Each index is only written by its' owning side and published with release/acquire semantics, so neither side ever has to wait for the other.
+// Slots are written and read in place: the producer fills the slot returned by reserve() and publishes it with push(),
+// the consumer reads the slot returned by front() and releases it with pop().
+template <typename T, unsigned int SIZE>
+class SpscQueue
+{
+private:
+    static_assert( SIZE > 0 && SIZE < 255, "SpscQueue size has to be between 1 and 254." );
+
+    // Constants
+    static const byte CAPACITY = SIZE + 1; // One slot always stays free, in order to distinguish a full from an empty queue.
+
+    // Variables
+    T slots[CAPACITY];
+    byte head = 0; // Next slot to be read; only written by the consumer.
+    byte tail = 0; // Next slot to be written; only written by the producer.
+    byte numDropped = 0; // Number of failed reserve() calls (wrapping); only written by the producer.
+
+    // Private Methods
+    // Returns the index following the given one.
+    static byte next( byte index )
+    {
+        return ( index + 1 ) % CAPACITY;
+    }
+
+    // Loads an index which has been published by the other side.
+    static byte load( const byte * index )
+    {
+        #if defined( __AVR__ )
+        // Single core, and byte accesses are atomic anyway
+        return *(const volatile byte *) index;
+        #else
+        return __atomic_load_n( index, __ATOMIC_ACQUIRE );
+        #endif
+    }
+
+    // Publishes an index to the other side, after all preceding writes to the slots.
+    static void store( byte * index, byte value )
+    {
+        #if defined( __AVR__ )
+        *(volatile byte *) index = value;
+        #else
+        __atomic_store_n( index, value, __ATOMIC_RELEASE );
+        #endif
+    }
+
+public:
+    // Producer: Returns the slot to be written next, or nullptr if the queue is full (which gets counted as a dropped element).
+    T * reserve()
+    {
+        if ( next( tail ) == load( &head ) )
+        {
+            store( &numDropped, numDropped + 1 );
+
+            return nullptr;
+        }
+
+        return &slots[tail];
+    }
+
+    // Producer: Returns whether the queue is full. The consumer can only make room concurrently, so if it isn't, the next reserve() succeeds.
+    bool isFull()
+    {
+        return next( tail ) == load( &head );
+    }
+
+    // Producer: Counts an element, which has been dropped without calling reserve().
+    void drop()
+    {
+        store( &numDropped, numDropped + 1 );
+    }
+
+    // Producer: Publishes the slot returned by reserve() to the consumer.
+    void push()
+    {
+        store( &tail, next( tail ) );
+    }
+
+    // Consumer: Returns the oldest slot, or nullptr if the queue is empty.
+    T * front()
+    {
+        if ( head == load( &tail ) )
+        {
+            return nullptr;
+        }
+
+        return &slots[head];
+    }
+
+    // Consumer: Releases the slot returned by front() to the producer.
+    void pop()
+    {
+        store( &head, next( head ) );
+    }
+
+    // Gets the number of dropped elements. It wraps around at 256, so only the difference between two calls is meaningful.
+    byte getNumDropped()
+    {
+        return load( &numDropped );
+    }
+
+    // Gets the number of queued elements. Only a snapshot, if the other side is running concurrently.
+    int getLength()
+    {
+        return ( load( &tail ) + CAPACITY - load( &head ) ) % CAPACITY;
+    }
+};
+
+#endif // SPSCQUEUE_HPP
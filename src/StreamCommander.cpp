@@ -17,6 +17,16 @@
 #include "StreamCommander.hpp"
 
 const String StreamCommander::PING_REPLY = "reply";
+const String StreamCommander::MESSAGE_TRANSFER = "transfer";
+const String StreamCommander::MESSAGE_CHUNK = "chunk";
+const String StreamCommander::MESSAGE_ACK = "ack";
+const String StreamCommander::MESSAGE_NAK = "nak";
+const String StreamCommander::MESSAGE_PENDING = "pending";
+const String StreamCommander::MESSAGE_DONE = "done";
+const String StreamCommander::MESSAGE_CANCELLED = "cancelled";
+const String StreamCommander::MESSAGE_SCHEMA = "schema";
+const String StreamCommander::MESSAGE_MODE = "mode";
+const String StreamCommander::MESSAGE_TELEMETRY = "telemetry";
 const String StreamCommander::COMMAND_ACTIVATE = "activate";
 const String StreamCommander::COMMAND_DEACTIVATE = "deactivate";
 const String StreamCommander::COMMAND_ISACTIVE = "isactive";
@@ -26,6 +36,17 @@ const String StreamCommander::COMMAND_GETID = "getid";
 const String StreamCommander::COMMAND_PING = "ping";
 const String StreamCommander::COMMAND_GETSTATUS = "getstatus";
 const String StreamCommander::COMMAND_LISTCOMMANDS = "commands";
+const String StreamCommander::COMMAND_PUSH = "push";
+const String StreamCommander::COMMAND_PULL = "pull";
+const String StreamCommander::COMMAND_CHUNK = "chunk";
+const String StreamCommander::COMMAND_ACK = "ack";
+const String StreamCommander::COMMAND_NAK = "nak";
+const String StreamCommander::COMMAND_ABORT = "abort";
+const String StreamCommander::COMMAND_CANCEL = "cancel";
+const String StreamCommander::COMMAND_SCHEMA = "schema";
+const String StreamCommander::COMMAND_SCHEMAHASH = "schemahash";
+const String StreamCommander::COMMAND_MODE = "mode";
+const String StreamCommander::COMMAND_KEYFRAME = "keyframe";
 
 StreamCommander::StreamCommander( Stream * streamInstance )
 {
@@ -35,6 +56,7 @@ StreamCommander::StreamCommander( Stream * streamInstance )
 StreamCommander::~StreamCommander()
 {
     deleteCommands();
+    free( structuredStatus );
 }
 
 void StreamCommander::init( bool active, char commandDelimiter, char messageDelimiter, bool echoCommands, bool addStandardCommands, long streamBufferTimeout )
@@ -43,6 +65,7 @@ void StreamCommander::init( bool active, char commandDelimiter, char messageDeli
     loadIdFromEeprom();
     #endif
 
+    addStandardMessageTypes();
     setCommandDelimiter( commandDelimiter );
     setMessageDelimiter( messageDelimiter );
     setStreamBufferTimeout( streamBufferTimeout );
@@ -113,6 +136,12 @@ char StreamCommander::getCommandDelimiter()
 void StreamCommander::setMessageDelimiter( char messageDelimiter )
 {
     this->messageDelimiter = messageDelimiter;
+
+    // Rebuild the header cache with the new delimiter
+    for ( int i = 0; i < numMessageTypes; i++ )
+    {
+        messageHeaders[i].setCharAt( messageHeaders[i].length() - 1, messageDelimiter );
+    }
 }
 
 char StreamCommander::getMessageDelimiter()
@@ -120,6 +149,87 @@ char StreamCommander::getMessageDelimiter()
     return this->messageDelimiter;
 }
 
+void StreamCommander::addStandardMessageTypes()
+{
+    if ( numMessageTypes > 0 )
+    {
+        return;
+    }
+
+    // The standard message types always come first, in the order of MessageTypeId
+    insertMessageType( MessageType::RESPONSE );
+    insertMessageType( MessageType::INFO );
+    insertMessageType( MessageType::ERROR );
+    insertMessageType( MessageType::PING );
+    insertMessageType( MessageType::STATUS );
+    insertMessageType( MessageType::ID );
+    insertMessageType( MessageType::ACTIVE );
+    insertMessageType( MessageType::ECHO );
+    insertMessageType( MessageType::COMMANDS );
+    insertMessageType( MessageType::COMMAND );
+    insertMessageType( MESSAGE_TRANSFER );
+    insertMessageType( MESSAGE_CHUNK );
+    insertMessageType( MESSAGE_ACK );
+    insertMessageType( MESSAGE_NAK );
+    insertMessageType( MESSAGE_PENDING );
+    insertMessageType( MESSAGE_DONE );
+    insertMessageType( MESSAGE_CANCELLED );
+    insertMessageType( MESSAGE_SCHEMA );
+    insertMessageType( MESSAGE_MODE );
+    insertMessageType( MESSAGE_TELEMETRY );
+}
+
+int StreamCommander::addMessageType( String type )
+{
+    // Custom message types get appended after the standard ones, regardless of whether they're registered before or after init()
+    addStandardMessageTypes();
+
+    return insertMessageType( type );
+}
+
+int StreamCommander::insertMessageType( const String & type )
+{
+    int index = getMessageTypeIndex( type );
+
+    if ( index >= 0 )
+    {
+        return index;
+    }
+
+    if ( numMessageTypes >= MAX_MESSAGE_TYPES )
+    {
+        return -1;
+    }
+
+    String & header = messageHeaders[numMessageTypes];
+    header.reserve( type.length() + 1 );
+    header = type;
+    header += getMessageDelimiter();
+
+    return numMessageTypes++;
+}
+
+int StreamCommander::getNumMessageTypes()
+{
+    return this->numMessageTypes;
+}
+
+int StreamCommander::getMessageTypeIndex( const String & type )
+{
+    unsigned int length = type.length();
+
+    for ( int i = 0; i < numMessageTypes; i++ )
+    {
+        // Compare the lengths first, so most types get skipped without looking at their characters
+        if ( messageHeaders[i].length() == length + 1 && messageHeaders[i].startsWith( type ) )
+        {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
 void StreamCommander::setEchoCommands( bool echoCommands )
 {
     this->echoCommands = echoCommands;
@@ -212,353 +322,2686 @@ String StreamCommander::getId()
 
 void StreamCommander::setStatus( String status )
 {
-    this->status = status;
+    if ( isStatusHashing() )
+    {
+        this->statusHash = hashStatus( status.c_str(), status.length() );
+        this->statusLength = status.length();
+    }
+    else
+    {
+        this->status = status;
+    }
+
+    this->statusDecimals = STATUS_TEXT;
 }
 
 void StreamCommander::updateStatus( String status )
 {
-    // Only update our status if it has actually changed
-    if ( !getStatus().equals( status ) )
-    {
-        setStatus( status );
-
-        // Only send a status update if our device is set active
-        if ( isActive() )
-        {
-            sendStatus();
-        }
-    }
+    updateTextStatus( status.c_str(), status.length() );
 }
 
-String StreamCommander::getStatus()
+void StreamCommander::updateStatus( int value )
 {
-    return this->status;
+    updateNumericStatus( value, 0 );
 }
 
-void StreamCommander::addCommand( String commandName, CommandCallbackFunction commandCallback )
+void StreamCommander::updateStatus( unsigned int value )
 {
-    // Check that the command name is not empty
-    if ( commandName.length() == 0 )
-    {
-        sendError( F( "Command name must not be empty." ) );
+    updateNumericStatus( value, 0 );
+}
 
-        return;
-    }
+void StreamCommander::updateStatus( long value )
+{
+    updateNumericStatus( value, 0 );
+}
 
-    // Check that the command callback function is not empty
-    if ( commandCallback == nullptr )
+void StreamCommander::updateStatus( unsigned long value )
+{
+    // Where unsigned long has 64 bits, the largest values don't fit into a fixed-point number
+    if ( (uint64_t) value > (uint64_t) INT64_MAX )
     {
-        sendError( F( "Command callback function must not be empty." ) );
+        String status( value );
+        updateTextStatus( status.c_str(), status.length() );
 
         return;
     }
 
-    // Sets the currentCommandIndex to -1 if this commandName has not been added yet, or to the array-index where it has been found
-    int currentCommandIndex = getCommandContainerIndex( commandName );
-    bool commandFound = true;
+    updateNumericStatus( value, 0 );
+}
 
-    // Check if the command has already been added or not
-    // If not: sets the index to the next index where the new command will be added
-    if ( currentCommandIndex < 0 )
+void StreamCommander::updateStatus( double value, byte decimals )
+{
+    if ( decimals > MAX_DECIMALS )
     {
-        currentCommandIndex = getNumCommands();
-        commandFound = false;
+        decimals = MAX_DECIMALS;
     }
 
-    // If the command has not been added yet, incease the array size and create a pointer to our commandName. Set the Callback in the next step.
-    // If it has already been added, just replace the old callback with the new one in the next step.
-    if ( !commandFound )
-    {
-        commands = (CommandContainer*) realloc( commands, ( currentCommandIndex + 1 ) * sizeof( CommandContainer ) );
-        incrementNumCommands();
+    int64_t scaledValue;
 
-        // Create a pointer to our command-name. On destruction of the corresponding CommandContainer, it will get deleted.
-        String * commandNamePointer = new String( commandName );
-        commands[currentCommandIndex].command = commandNamePointer;
-    }
-    else
+    if ( scaleNumber( value, decimals, scaledValue ) )
     {
-        sendInfo( "Command '" + commandName + "' already found. Replacing with new callback function." );
+        updateNumericStatus( scaledValue, decimals );
+
+        return;
     }
 
-    // Set the Callback-Function
-    commands[currentCommandIndex].callbackFunction = commandCallback;
+    // Not a number, or too large for a fixed-point number
+    char buffer[NUMBER_BUFFER_SIZE];
+    int length = formatNumber( buffer, value, decimals );
+    updateTextStatus( buffer, length );
 }
 
-StreamCommander::CommandContainer * StreamCommander::getCommandContainer( String command )
+void StreamCommander::updateStatus( const int * values, byte numValues )
 {
-    for ( int i = 0; i < getNumCommands(); i++ )
+    if ( !checkNumValues( numValues ) )
     {
-        if ( commands[i].command->equals( command ) )
-        {
-            return &commands[i];
-        }
+        return;
     }
 
-    return nullptr;
-}
+    int64_t scaledValues[MAX_VALUES];
 
-int StreamCommander::getCommandContainerIndex( String command )
-{
-    for ( int i = 0; i < getNumCommands(); i++ )
+    for ( byte i = 0; i < numValues; i++ )
     {
-        if ( commands[i].command->equals( command ) )
-        {
-            return i;
-        }
+        scaledValues[i] = values[i];
     }
 
-    return -1;
-}
-
-void StreamCommander::deleteCommands()
-{
-    delete[] commands;
-    setNumCommands( 0 );
-}
-
-void StreamCommander::setNumCommands( int numCommands )
-{
-    this->numCommands = numCommands;
-}
-
-void StreamCommander::incrementNumCommands()
-{
-    this->numCommands++;
-}
-
-int StreamCommander::getNumCommands()
-{
-    return this->numCommands;
+    updateValuesStatus( scaledValues, numValues, 0 );
 }
 
-String StreamCommander::getCommandList()
+void StreamCommander::updateStatus( const float * values, byte numValues, byte decimals )
 {
-    String commandList = "";
-    String commandSeparator = ", ";
-
-    for ( int i = 0; i < getNumCommands(); i++ )
+    if ( !checkNumValues( numValues ) )
     {
-        commandList = commandList + *(commands[i].command) + commandSeparator;
+        return;
     }
 
-    // Remove the last commandSeparator occurence
-    unsigned int listLength = commandList.length();
-    unsigned int separatorLength = commandSeparator.length();
-
-    if ( listLength > 0 )
+    if ( decimals > MAX_DECIMALS )
     {
-        commandList.remove( listLength - separatorLength, separatorLength );
+        decimals = MAX_DECIMALS;
     }
 
-    return commandList;
-}
+    int64_t scaledValues[MAX_VALUES];
 
-void StreamCommander::setDefaultCallback( DefaultCallbackFunction defaultCallbackFunction )
-{
-    // Check that the default callback function is not empty
-    if ( defaultCallbackFunction == nullptr )
+    for ( byte i = 0; i < numValues; i++ )
     {
-        sendError( F( "Default callback function must not be empty." ) );
+        // Not a number, or too large for a fixed-point number
+        if ( !scaleNumber( values[i], decimals, scaledValues[i] ) )
+        {
+            char buffer[VALUES_BUFFER_SIZE];
+            int length = formatValues( buffer, values, numValues, decimals );
+            updateTextStatus( buffer, length );
 
-        return;
+            return;
+        }
     }
 
-    this->defaultCallbackFunction = defaultCallbackFunction;
+    updateValuesStatus( scaledValues, numValues, decimals );
 }
 
-StreamCommander::DefaultCallbackFunction StreamCommander::getDefaultCallback()
+void StreamCommander::updateNumericStatus( int64_t value, byte decimals )
 {
-    return this->defaultCallbackFunction;
-}
+    bool due = isStatusDue();
 
-void StreamCommander::executeCommand( String command, String arguments )
-{
-    // Send an Echo
-    if ( shouldEchoCommands() )
+    // Only format our status if the number has actually changed
+    if ( this->statusDecimals == decimals && this->statusValue == value && !due )
     {
-        if ( arguments.length() )
-        {
-            sendEcho( command + " " + arguments );
-        }
-        else
-        {
-            sendEcho( command );
-        }
+        return;
     }
 
-    // Try to find our input-command and execute it
-    CommandContainer * container = getCommandContainer( command );
+    this->statusValue = value;
+    this->statusDecimals = decimals;
 
-    // If a container for this command has been found, try to call the callback
-    if ( container != nullptr )
+    char buffer[NUMBER_BUFFER_SIZE];
+    int length = formatNumber( buffer, value, decimals );
+
+    if ( !isStatusHashing() )
     {
-        if ( container->callbackFunction != nullptr )
-        {
-            // Call our Callback-Function with the arguments and our object-instance
-            container->callbackFunction( arguments, this );
-        }
-        else
+        // The status might have been set to the same text by updateStatus( String ) before
+        if ( strcmp( this->status.c_str(), buffer ) == 0 && !due )
         {
-            sendError( "Command callback function for command '" + command + "' is empty." );
+            return;
         }
+
+        this->status = buffer;
     }
-    else
-    {
-        getDefaultCallback()( command, arguments, this );
-    }
+
+    sendUpdatedStatus( buffer, length );
 }
 
-void StreamCommander::fetchCommand()
+void StreamCommander::updateValuesStatus( const int64_t * values, byte numValues, byte decimals )
 {
-    Stream * streamInstance = getStreamInstance();
-    String commandBuffer = "";
+    bool due = isStatusDue();
 
-    // Only execute when a command is available
-    if ( streamInstance->available() )
-    {
-        commandBuffer = streamInstance->readString();
-    }
-    else
+    // Only format our status if the numbers have actually changed
+    if ( this->statusDecimals == STATUS_VALUES && this->statusValuesDecimals == decimals && this->numStatusValues == numValues && memcmp( this->statusValues, values, numValues * sizeof( int64_t ) ) == 0 && !due )
     {
         return;
     }
 
-    // Check for the first CR or NL occuring in our string.
-    int cr = commandBuffer.indexOf( COMMAND_EOL_CR );
-    int nl = commandBuffer.indexOf( COMMAND_EOL_NL );
-    int stringEnd = -1;
+    memcpy( this->statusValues, values, numValues * sizeof( int64_t ) );
+    this->numStatusValues = numValues;
+    this->statusValuesDecimals = decimals;
+    this->statusDecimals = STATUS_VALUES;
 
-    if ( cr > 0 && nl > 0 )
-    {
-        stringEnd = min( cr, nl );
-    }
-    else if ( cr > 0 )
-    {
-        stringEnd = cr;
-    }
-    else if ( nl > 0 )
-    {
-        stringEnd = nl;
-    }
-    else // If there's no CR/NL at all, or if it's the first character, return -> no valid command found
+    char buffer[VALUES_BUFFER_SIZE];
+    int length = formatValues( buffer, values, numValues, decimals );
+
+    if ( !isStatusHashing() )
     {
-        return;
+        // The status might have been set to the same text by updateStatus( String ) before
+        if ( strcmp( this->status.c_str(), buffer ) == 0 && !due )
+        {
+            return;
+        }
+
+        this->status = buffer;
     }
 
-    // Parse command from buffer
-    int commandEnd = commandBuffer.indexOf( getCommandDelimiter() );
-    String command = "";
-    String arguments = "";
+    sendUpdatedStatus( buffer, length );
+}
 
-    // If there is no command-delimiter, we can't parse any arguments (cause there probably are none)
-    if ( commandEnd == -1 )
+void StreamCommander::updateTextStatus( const char * status, int length )
+{
+    bool due = isStatusDue();
+
+    if ( isStatusHashing() )
     {
-        // Set commandEnd to stringEnd, since our command ends there if no arguments are given
-        commandEnd = stringEnd;
+        uint32_t hash = hashStatus( status, length );
+
+        // Only update our status if its' hash or length has changed
+        if ( this->statusDecimals == STATUS_TEXT && this->statusHash == hash && this->statusLength == length && !due )
+        {
+            return;
+        }
+
+        this->statusHash = hash;
+        this->statusLength = length;
     }
     else
     {
-        arguments = commandBuffer.substring( commandEnd + 1, stringEnd );
-    }
+        // Compare the buffer with our status in place, instead of constructing a String from it
+        if ( this->statusDecimals != STATUS_STRUCTURED && strcmp( this->status.c_str(), status ) == 0 && !due )
+        {
+            return;
+        }
 
-    command = commandBuffer.substring( 0, commandEnd );
+        this->status = status;
+    }
 
-    executeCommand( command, arguments );
+    this->statusDecimals = STATUS_TEXT;
+    sendUpdatedStatus( status, length );
 }
 
-void StreamCommander::sendMessage( String type, String content )
+void StreamCommander::sendUpdatedStatus( const char * status, int length, ContentFormat format )
 {
-    getStreamInstance()->println( type + getMessageDelimiter() + content );
+    // Only send a status update if our device is set active, or the status has been requested
+    if ( isActive() || this->statusRequested )
+    {
+        sendMessage( TYPE_STATUS, status, length, format );
+        this->statusSentTime = millis();
+        this->statusRequested = false;
+    }
 }
 
-void StreamCommander::sendResponse( String response )
+bool StreamCommander::isStatusDue()
 {
-    sendMessage( MessageType::RESPONSE, response );
-}
+    if ( this->statusRequested )
+    {
+        return true;
+    }
 
-void StreamCommander::sendInfo( String info )
-{
-    sendMessage( MessageType::INFO, info );
+    return this->statusRefreshInterval > 0 && millis() - this->statusSentTime >= this->statusRefreshInterval;
 }
 
-void StreamCommander::sendError( String error )
+uint32_t StreamCommander::hashStatus( const char * status, int length )
 {
-    sendMessage( MessageType::ERROR, error );
-}
+    uint32_t hash = COMMAND_HASH_OFFSET;
 
-void StreamCommander::sendPing()
-{
-    sendMessage( MessageType::PING, PING_REPLY );
-}
+    for ( int i = 0; i < length; i++ )
+    {
+        hash = updateCommandHash( hash, status[i] );
+    }
 
-void StreamCommander::sendStatus()
-{
-    sendMessage( MessageType::STATUS, getStatus() );
+    return hash;
 }
 
-void StreamCommander::sendId()
+void StreamCommander::setStatusHashing( bool statusHashing )
 {
-    sendMessage( MessageType::ID, getId() );
-}
+    if ( statusHashing && !isStatusHashing() )
+    {
+        // Only keep the hash of the current status, and release the status itself
+        if ( this->statusDecimals == STATUS_STRUCTURED )
+        {
+            this->statusHash = hashStatus( this->structuredStatus, this->statusLength );
+        }
+        else
+        {
+            this->statusHash = hashStatus( this->status.c_str(), this->status.length() );
+            this->statusLength = this->status.length();
+        }
 
-void StreamCommander::sendIsActive()
-{
-    sendMessage( MessageType::ACTIVE, String( isActive() ) );
+        this->status = String();
+        free( this->structuredStatus );
+        this->structuredStatus = nullptr;
+        this->structuredStatusCapacity = 0;
+    }
+
+    this->statusHashing = statusHashing;
 }
 
-void StreamCommander::sendEcho( String echo )
+bool StreamCommander::isStatusHashing()
 {
-    sendMessage( MessageType::ECHO, echo );
+    return this->statusHashing;
 }
 
-void StreamCommander::sendCommands()
+void StreamCommander::setStatusRefreshInterval( unsigned long statusRefreshInterval )
 {
-    sendMessage( MessageType::COMMANDS, getCommandList() );
+    this->statusRefreshInterval = statusRefreshInterval;
 }
 
-void StreamCommander::commandActivate( String arguments, StreamCommander * instance )
+unsigned long StreamCommander::getStatusRefreshInterval()
 {
-    instance->setActive( true );
+    return this->statusRefreshInterval;
 }
 
-void StreamCommander::commandDeactivate( String arguments, StreamCommander * instance )
+void StreamCommander::setStatusProvider( StatusProviderFunction statusProviderFunction, unsigned long interval )
 {
-    instance->setActive( false );
+    this->statusProviderFunction = statusProviderFunction;
+    this->statusProviderInterval = interval;
+    this->statusProviderTime = millis() - interval; // Due right away
 }
 
-void StreamCommander::commandIsActive( String arguments, StreamCommander * instance )
+StreamCommander::StatusProviderFunction StreamCommander::getStatusProvider()
 {
-    instance->sendIsActive();
+    return this->statusProviderFunction;
 }
 
-void StreamCommander::commandSetEcho( String arguments, StreamCommander * instance )
+void StreamCommander::processStatusProvider()
 {
-    arguments.trim();
+    StatusProviderFunction statusProviderFunction = getStatusProvider();
 
-    if ( arguments.equals( "on" ) )
+    // Idle devices don't need to format any status
+    if ( statusProviderFunction == nullptr || !isActive() )
     {
-        instance->setEchoCommands( true );
+        return;
     }
-    else if ( arguments.equals( "off" ) )
+
+    if ( millis() - this->statusProviderTime < this->statusProviderInterval )
     {
-        instance->setEchoCommands( false );
+        return;
     }
-}
 
-void StreamCommander::commandSetId( String id, StreamCommander * instance )
-{
-    id.trim();
-    instance->setId( id );
+    this->statusProviderTime = millis();
+    statusProviderFunction( this );
 }
 
-void StreamCommander::commandGetId( String arguments, StreamCommander * instance )
+String StreamCommander::getStatus()
 {
-    instance->sendId();
-}
+    // While hashing, only a numeric status can be restored
+    if ( isStatusHashing() && this->statusDecimals <= MAX_DECIMALS )
+    {
+        char buffer[NUMBER_BUFFER_SIZE];
+        formatNumber( buffer, this->statusValue, this->statusDecimals );
 
-void StreamCommander::commandPing( String arguments, StreamCommander * instance )
-{
+        return String( buffer );
+    }
+
+    // An array status can be restored from its' numbers as well
+    if ( isStatusHashing() && this->statusDecimals == STATUS_VALUES )
+    {
+        char buffer[VALUES_BUFFER_SIZE];
+        formatValues( buffer, this->statusValues, this->numStatusValues, this->statusValuesDecimals );
+
+        return String( buffer );
+    }
+
+    if ( this->statusDecimals == STATUS_STRUCTURED && !isStatusHashing() )
+    {
+        String status;
+        status.concat( this->structuredStatus, this->statusLength );
+
+        return status;
+    }
+
+    return this->status;
+}
+
+MessagePackWriter & StreamCommander::beginStructuredStatus()
+{
+    statusBuffer.content = "";
+
+    return statusWriter;
+}
+
+void StreamCommander::endStructuredStatus()
+{
+    const char * status = statusBuffer.content.c_str();
+    int length = statusBuffer.content.length();
+    bool due = isStatusDue();
+
+    if ( isStatusHashing() )
+    {
+        uint32_t hash = hashStatus( status, length );
+
+        if ( this->statusDecimals == STATUS_STRUCTURED && this->statusHash == hash && this->statusLength == length && !due )
+        {
+            return;
+        }
+
+        this->statusHash = hash;
+    }
+    else
+    {
+        // MessagePack may contain zero bytes, so the whole content gets compared
+        if ( this->statusDecimals == STATUS_STRUCTURED && this->statusLength == length && memcmp( this->structuredStatus, status, length ) == 0 && !due )
+        {
+            return;
+        }
+
+        // Copying a String stops at the first zero byte on some cores, so the bytes get kept in a buffer of our own, which only ever grows
+        if ( length > this->structuredStatusCapacity )
+        {
+            char * structuredStatus = (char *) realloc( this->structuredStatus, length );
+
+            if ( structuredStatus == nullptr )
+            {
+                sendError( "Not enough memory to keep a structured status of " + String( length ) + " bytes." );
+
+                return;
+            }
+
+            this->structuredStatus = structuredStatus;
+            this->structuredStatusCapacity = length;
+        }
+
+        memcpy( this->structuredStatus, status, length );
+        this->status = String();
+    }
+
+    this->statusLength = length;
+    this->statusDecimals = STATUS_STRUCTURED;
+    sendUpdatedStatus( status, length, CONTENT_STRUCTURED );
+}
+
+JsonWriter & StreamCommander::beginJsonStatus()
+{
+    statusBuffer.content = "";
+    statusJsonWriter.reset( statusBuffer );
+
+    return statusJsonWriter;
+}
+
+void StreamCommander::endJsonStatus()
+{
+    updateTextStatus( statusBuffer.content.c_str(), statusBuffer.content.length() );
+}
+
+void StreamCommander::publishStatus( const char * status )
+{
+    // An odd sequence number marks the snapshot as being written
+    statusSnapshotSequence = statusSnapshotSequence + 1;
+    memoryBarrier();
+
+    int i = 0;
+
+    for ( ; i < STATUS_SNAPSHOT_LENGTH && status[i] != '\0'; i++ )
+    {
+        statusSnapshot[i] = status[i];
+    }
+
+    statusSnapshot[i] = '\0';
+
+    memoryBarrier();
+    statusSnapshotSequence = statusSnapshotSequence + 1;
+}
+
+void StreamCommander::processStatusSnapshot()
+{
+    byte sequence = statusSnapshotSequence;
+
+    // Nothing has been published since the last call
+    if ( sequence == statusSnapshotReadSequence )
+    {
+        return;
+    }
+
+    char snapshot[STATUS_SNAPSHOT_LENGTH + 1];
+
+    // Copy the snapshot, and try again if it has been (or is being) written in the meantime
+    // The number of attempts is limited, since a publisher which has been preempted by us would never finish writing
+    bool consistent = false;
+
+    for ( int attempt = 0; attempt < STATUS_SNAPSHOT_RETRIES && !consistent; attempt++ )
+    {
+        sequence = statusSnapshotSequence;
+        memoryBarrier();
+
+        if ( sequence & 1 )
+        {
+            continue;
+        }
+
+        for ( int i = 0; i <= STATUS_SNAPSHOT_LENGTH; i++ )
+        {
+            snapshot[i] = statusSnapshot[i];
+        }
+
+        memoryBarrier();
+        consistent = sequence == statusSnapshotSequence;
+    }
+
+    // Keep the current status, and try again on the next call
+    if ( !consistent )
+    {
+        return;
+    }
+
+    statusSnapshotReadSequence = sequence;
+    snapshot[STATUS_SNAPSHOT_LENGTH] = '\0';
+
+    updateTextStatus( snapshot, strlen( snapshot ) );
+}
+
+void StreamCommander::memoryBarrier()
+{
+    #if defined( __AVR__ )
+    // Single core, so only the compiler must not reorder
+    asm volatile( "" ::: "memory" );
+    #else
+    __atomic_thread_fence( __ATOMIC_SEQ_CST );
+    #endif
+}
+
+void StreamCommander::addCommand( String commandName, CommandCallbackFunction commandCallback )
+{
+    registerCommand( commandName, commandCallback, nullptr, 0, false );
+}
+
+void StreamCommander::addPriorityCommand( String commandName, CommandCallbackFunction commandCallback )
+{
+    registerCommand( commandName, commandCallback, nullptr, 0, true );
+}
+
+void StreamCommander::addAsyncCommand( String commandName, AsyncCommandCallbackFunction commandCallback, unsigned long timeout )
+{
+    registerCommand( commandName, nullptr, commandCallback, timeout, false );
+}
+
+void StreamCommander::registerCommand( String commandName, CommandCallbackFunction commandCallback, AsyncCommandCallbackFunction asyncCommandCallback, unsigned long timeout, bool priority )
+{
+    // Check that the command name is not empty
+    if ( commandName.length() == 0 )
+    {
+        sendError( F( "Command name must not be empty." ) );
+
+        return;
+    }
+
+    // Check that the command callback function is not empty
+    if ( commandCallback == nullptr && asyncCommandCallback == nullptr )
+    {
+        sendError( F( "Command callback function must not be empty." ) );
+
+        return;
+    }
+
+    // Sets the currentCommandIndex to -1 if this commandName has not been added yet, or to the array-index where it has been found
+    uint32_t hash = hashCommand( commandName );
+    int currentCommandIndex = getCommandContainerIndex( commandName, hash );
+    bool commandFound = true;
+
+    // Check if the command has already been added or not
+    // If not: sets the index to the next index where the new command will be added
+    if ( currentCommandIndex < 0 )
+    {
+        currentCommandIndex = getNumCommands();
+        commandFound = false;
+    }
+
+    // If the command has not been added yet, incease the array size and create a pointer to our commandName. Set the Callback in the next step.
+    // If it has already been added, just replace the old callback with the new one in the next step.
+    if ( !commandFound )
+    {
+        commands = (CommandContainer*) realloc( commands, ( currentCommandIndex + 1 ) * sizeof( CommandContainer ) );
+        incrementNumCommands();
+
+        // Create a pointer to our command-name. On destruction of the corresponding CommandContainer, it will get deleted.
+        String * commandNamePointer = new String( commandName );
+        commands[currentCommandIndex].command = commandNamePointer;
+        commands[currentCommandIndex].hash = hash;
+        commands[currentCommandIndex].argumentTypes = nullptr;
+        commands[currentCommandIndex].messageTypes = nullptr;
+        invalidateCommandList();
+    }
+    else
+    {
+        sendInfo( "Command '" + commandName + "' already found. Replacing with new callback function." );
+    }
+
+    // Set the Callback-Function; only one of them is set
+    commands[currentCommandIndex].callbackFunction = commandCallback;
+    commands[currentCommandIndex].asyncCallbackFunction = asyncCommandCallback;
+    commands[currentCommandIndex].timeout = timeout;
+    commands[currentCommandIndex].priority = priority;
+}
+
+StreamCommander::CommandContainer * StreamCommander::getCommandContainer( String command, uint32_t hash )
+{
+    int index = getCommandContainerIndex( command, hash );
+
+    if ( index < 0 )
+    {
+        return nullptr;
+    }
+
+    return &commands[index];
+}
+
+int StreamCommander::getCommandContainerIndex( String command, uint32_t hash )
+{
+    for ( int i = 0; i < getNumCommands(); i++ )
+    {
+        // Only compare the names if the hashes match, which is usually only the case for the command we're looking for
+        if ( commands[i].hash == hash && commands[i].command->equals( command ) )
+        {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+uint32_t StreamCommander::hashCommand( String command )
+{
+    uint32_t hash = COMMAND_HASH_OFFSET;
+
+    for ( unsigned int i = 0; i < command.length(); i++ )
+    {
+        hash = updateCommandHash( hash, command.charAt( i ) );
+    }
+
+    return hash;
+}
+
+uint32_t StreamCommander::updateCommandHash( uint32_t hash, char character )
+{
+    return ( hash ^ (byte) character ) * COMMAND_HASH_PRIME;
+}
+
+void StreamCommander::removeCommand( String command )
+{
+    int index = getCommandContainerIndex( command, hashCommand( command ) );
+
+    if ( index < 0 )
+    {
+        sendError( "Command '" + command + "' not registered." );
+
+        return;
+    }
+
+    // Destroy the name, and move the following commands one position up
+    delete commands[index].command;
+    memmove( &commands[index], &commands[index + 1], ( getNumCommands() - index - 1 ) * sizeof( CommandContainer ) );
+    setNumCommands( getNumCommands() - 1 );
+    invalidateCommandList();
+}
+
+void StreamCommander::deleteCommands()
+{
+    // The names have been created with new, but the array itself with realloc()
+    for ( int i = 0; i < getNumCommands(); i++ )
+    {
+        delete commands[i].command;
+    }
+
+    free( commands );
+    commands = nullptr;
+    setNumCommands( 0 );
+    invalidateCommandList();
+}
+
+void StreamCommander::invalidateCommandList()
+{
+    this->commandListValid = false;
+    this->schemaHashValid = false;
+}
+
+void StreamCommander::setNumCommands( int numCommands )
+{
+    this->numCommands = numCommands;
+}
+
+void StreamCommander::incrementNumCommands()
+{
+    this->numCommands++;
+}
+
+int StreamCommander::getNumCommands()
+{
+    return this->numCommands;
+}
+
+String StreamCommander::getCommandList()
+{
+    if ( this->commandListValid )
+    {
+        return this->commandList;
+    }
+
+    String commandSeparator = ", ";
+    unsigned int listLength = 0;
+
+    // Allocate the whole list at once, instead of growing it command by command
+    for ( int i = 0; i < getNumCommands(); i++ )
+    {
+        listLength += commands[i].command->length() + commandSeparator.length();
+    }
+
+    this->commandList = "";
+    this->commandList.reserve( listLength );
+
+    for ( int i = 0; i < getNumCommands(); i++ )
+    {
+        if ( i > 0 )
+        {
+            this->commandList += commandSeparator;
+        }
+
+        this->commandList += *(commands[i].command);
+    }
+
+    this->commandListValid = true;
+
+    return this->commandList;
+}
+
+void StreamCommander::describeCommand( String command, const char * argumentTypes, const char * messageTypes )
+{
+    CommandContainer * commandContainer = getCommandContainer( command, hashCommand( command ) );
+
+    if ( commandContainer == nullptr )
+    {
+        sendError( "Command '" + command + "' not registered." );
+
+        return;
+    }
+
+    commandContainer->argumentTypes = argumentTypes;
+    commandContainer->messageTypes = messageTypes;
+    invalidateCommandList();
+}
+
+uint32_t StreamCommander::getSchemaHash()
+{
+    if ( !this->schemaHashValid )
+    {
+        HashBuffer hashBuffer;
+        printSchema( hashBuffer );
+
+        this->schemaHash = hashBuffer.hash;
+        this->schemaHashValid = true;
+    }
+
+    return this->schemaHash;
+}
+
+void StreamCommander::printSchema( Print & output )
+{
+    for ( int i = 0; i < getNumCommands(); i++ )
+    {
+        output.print( SCHEMA_ENTRY_DELIMITER );
+        output.print( i );
+        output.print( SCHEMA_FIELD_DELIMITER );
+        output.print( *(commands[i].command) );
+        output.print( SCHEMA_FIELD_DELIMITER );
+        printSchemaField( output, commands[i].argumentTypes );
+        output.print( SCHEMA_FIELD_DELIMITER );
+        printSchemaMessageTypes( output, commands[i].messageTypes );
+    }
+}
+
+void StreamCommander::printSchemaMessageTypes( Print & output, const char * messageTypes )
+{
+    if ( messageTypes == nullptr || messageTypes[0] == '\0' )
+    {
+        output.print( SCHEMA_EMPTY_FIELD );
+
+        return;
+    }
+
+    // Hosts decoding binary messages need the IDs, which depend on the order of registration, so every type gets followed by its' ID (e.g. "response=0,error=2")
+    const char * start = messageTypes;
+
+    while ( true )
+    {
+        const char * end = strchr( start, SCHEMA_LIST_DELIMITER );
+        String type;
+        type.concat( start, end != nullptr ? end - start : strlen( start ) );
+
+        output.print( type );
+
+        int index = getMessageTypeIndex( type );
+
+        if ( index >= 0 )
+        {
+            output.print( SCHEMA_ID_DELIMITER );
+            output.print( index );
+        }
+
+        if ( end == nullptr )
+        {
+            break;
+        }
+
+        output.print( SCHEMA_LIST_DELIMITER );
+        start = end + 1;
+    }
+}
+
+void StreamCommander::printSchemaField( Print & output, const char * field )
+{
+    if ( field == nullptr || field[0] == '\0' )
+    {
+        output.print( SCHEMA_EMPTY_FIELD );
+
+        return;
+    }
+
+    output.print( field );
+}
+
+void StreamCommander::setDefaultCallback( DefaultCallbackFunction defaultCallbackFunction )
+{
+    // Check that the default callback function is not empty
+    if ( defaultCallbackFunction == nullptr )
+    {
+        sendError( F( "Default callback function must not be empty." ) );
+
+        return;
+    }
+
+    this->defaultCallbackFunction = defaultCallbackFunction;
+}
+
+StreamCommander::DefaultCallbackFunction StreamCommander::getDefaultCallback()
+{
+    return this->defaultCallbackFunction;
+}
+
+void StreamCommander::executeCommand( String command, String arguments, uint32_t hash )
+{
+    // Send an Echo
+    if ( shouldEchoCommands() )
+    {
+        if ( arguments.length() )
+        {
+            sendEcho( command + " " + arguments );
+        }
+        else
+        {
+            sendEcho( command );
+        }
+    }
+
+    // Try to find our input-command and execute it
+    CommandContainer * container = getCommandContainer( command, hash );
+
+    // If a container for this command has been found, try to call the callback
+    if ( container != nullptr )
+    {
+        if ( container->asyncCallbackFunction != nullptr )
+        {
+            startAsyncCommand( command, arguments, container->asyncCallbackFunction, container->timeout );
+        }
+        else if ( container->callbackFunction != nullptr )
+        {
+            // Call our Callback-Function with the arguments and our object-instance
+            container->callbackFunction( static_cast<String &&>( arguments ), this );
+        }
+        else
+        {
+            sendError( "Command callback function for command '" + command + "' is empty." );
+        }
+    }
+    else
+    {
+        getDefaultCallback()( command, static_cast<String &&>( arguments ), this );
+    }
+}
+
+void StreamCommander::startAsyncCommand( String command, String arguments, AsyncCommandCallbackFunction callbackFunction, unsigned long timeout )
+{
+    // Check beforehand that the command could be kept pending, since it can't be stopped anymore once it's running
+    if ( numPendingCommands >= MAX_PENDING_COMMANDS )
+    {
+        sendError( "Too many pending commands to execute '" + command + "' (MAX_PENDING_COMMANDS = " + String( MAX_PENDING_COMMANDS ) + ")." );
+
+        return;
+    }
+
+    this->requestTag = this->nextRequestTag++;
+
+    // Skip 0 when the tags wrap around
+    if ( this->nextRequestTag == 0 )
+    {
+        this->nextRequestTag = 1;
+    }
+
+    if ( callbackFunction( arguments, this ) == PENDING )
+    {
+        PendingCommand & pendingCommand = pendingCommands[numPendingCommands++];
+        pendingCommand.callbackFunction = callbackFunction;
+        pendingCommand.arguments = arguments;
+        pendingCommand.tag = this->requestTag;
+        pendingCommand.startTime = millis();
+        pendingCommand.timeout = timeout;
+
+        sendMessage( TYPE_PENDING, String( this->requestTag ) + " " + command );
+    }
+}
+
+void StreamCommander::processPendingCommands()
+{
+    int i = 0;
+
+    while ( i < numPendingCommands )
+    {
+        PendingCommand & pendingCommand = pendingCommands[i];
+        this->requestTag = pendingCommand.tag;
+
+        // Stop commands which exceeded their deadline, instead of letting them tie up a pending slot any longer
+        if ( pendingCommand.timeout > 0 && millis() - pendingCommand.startTime >= pendingCommand.timeout )
+        {
+            sendError( "Request " + String( pendingCommand.tag ) + " timed out after " + String( pendingCommand.timeout ) + " ms." );
+            stopPendingCommand( i );
+
+            continue;
+        }
+
+        if ( pendingCommand.callbackFunction( pendingCommand.arguments, this ) == PENDING )
+        {
+            i++;
+
+            continue;
+        }
+
+        sendMessage( TYPE_DONE, String( pendingCommand.tag ) );
+        removePendingCommand( i );
+    }
+}
+
+void StreamCommander::stopPendingCommand( int index )
+{
+    PendingCommand & pendingCommand = pendingCommands[index];
+
+    this->requestTag = pendingCommand.tag;
+    this->cancelling = true;
+    pendingCommand.callbackFunction( pendingCommand.arguments, this );
+    this->cancelling = false;
+
+    removePendingCommand( index );
+}
+
+void StreamCommander::removePendingCommand( int index )
+{
+    // Close the gap, so the pending commands keep being called in the order they were started
+    numPendingCommands--;
+
+    for ( int i = index; i < numPendingCommands; i++ )
+    {
+        pendingCommands[i] = pendingCommands[i + 1];
+    }
+
+    pendingCommands[numPendingCommands].arguments = "";
+}
+
+bool StreamCommander::cancelCommand( unsigned int tag )
+{
+    for ( int i = 0; i < numPendingCommands; i++ )
+    {
+        if ( pendingCommands[i].tag == tag )
+        {
+            stopPendingCommand( i );
+            sendMessage( TYPE_CANCELLED, String( tag ) );
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool StreamCommander::isCancelled()
+{
+    return this->cancelling;
+}
+
+unsigned int StreamCommander::getRequestTag()
+{
+    return this->requestTag;
+}
+
+int StreamCommander::getNumPendingCommands()
+{
+    return this->numPendingCommands;
+}
+
+void StreamCommander::addFastCommand( char trigger, FastCommandCallbackFunction commandCallback )
+{
+    // Check that the fast command callback function is not empty
+    if ( commandCallback == nullptr )
+    {
+        sendError( F( "Fast command callback function must not be empty." ) );
+
+        return;
+    }
+
+    // Line endings can't be triggers, since they're needed to terminate the regular commands
+    if ( trigger == COMMAND_EOL_CR || trigger == COMMAND_EOL_NL )
+    {
+        sendError( F( "Fast command trigger must not be a line ending." ) );
+
+        return;
+    }
+
+    int index = 0;
+
+    // Replace the callback if the trigger has already been added
+    while ( index < numFastCommands && fastCommands[index].trigger != trigger )
+    {
+        index++;
+    }
+
+    if ( index >= MAX_FAST_COMMANDS )
+    {
+        sendError( "Too many fast commands (MAX_FAST_COMMANDS = " + String( MAX_FAST_COMMANDS ) + ")." );
+
+        return;
+    }
+
+    fastCommands[index].trigger = trigger;
+    fastCommands[index].callbackFunction = commandCallback;
+
+    // Only publish the new entry after it has been completely written, since receiveByte() might run in an interrupt
+    if ( index == numFastCommands )
+    {
+        numFastCommands++;
+    }
+}
+
+void StreamCommander::receiveByte( char character )
+{
+    receiveBytes( &character, 1 );
+}
+
+void StreamCommander::receiveBytes( const char * data, int length )
+{
+    Codec * codec = getCodec();
+
+    // A partially received command of the previous codec can't be completed anymore
+    if ( codec != this->receiveCodec )
+    {
+        resetReceiveState();
+        codec->resetDecoder();
+        this->receiveCodec = codec;
+    }
+
+    codec->decode( this, data, length );
+}
+
+void StreamCommander::receiveTextBytes( const char * data, int length )
+{
+    // Collect all bytes which interrupt a run of regular characters: line endings, fast command triggers, and the command delimiter as long as it hasn't occured in this line yet
+    char stopBytes[3 + MAX_FAST_COMMANDS] = { COMMAND_EOL_CR, COMMAND_EOL_NL };
+    int numStopBytes = 2;
+    int numTriggers = numFastCommands;
+
+    for ( int i = 0; i < numTriggers; i++ )
+    {
+        stopBytes[numStopBytes++] = fastCommands[i].trigger;
+    }
+
+    int position = 0;
+
+    while ( position < length )
+    {
+        // Put the delimiter last, so it can be dropped from the search once it has been found
+        int numSearchedStopBytes = numStopBytes;
+
+        if ( lineCommandEnd < 0 )
+        {
+            stopBytes[numSearchedStopBytes++] = getCommandDelimiter();
+        }
+
+        int stop = position + findStopByte( data + position, length - position, stopBytes, numSearchedStopBytes );
+
+        // Append the run of regular characters at once, and keep hashing the command name as long as its' end hasn't been reached
+        int appended = appendToLine( data + position, stop - position );
+
+        if ( lineCommandEnd < 0 )
+        {
+            for ( int i = 0; i < appended; i++ )
+            {
+                lineCommandHash = updateCommandHash( lineCommandHash, data[position + i] );
+            }
+        }
+
+        position = stop;
+
+        if ( stop >= length )
+        {
+            break;
+        }
+
+        char character = data[position++];
+
+        // Fast commands come first, before the byte touches any buffer
+        if ( matchFastCommand( character ) )
+        {
+            continue;
+        }
+
+        if ( character != COMMAND_EOL_CR && character != COMMAND_EOL_NL )
+        {
+            // The first command delimiter separates the command from its' arguments
+            if ( appendToLine( &character, 1 ) > 0 )
+            {
+                lineCommandEnd = lineLength - 1;
+            }
+
+            continue;
+        }
+
+        // Overlong lines get counted, and reported by the dispatching side
+        if ( lineOverflow )
+        {
+            numOverflowedLines = numOverflowedLines + 1;
+        }
+
+        // CR or NL terminate the current line; empty lines (e.g. the NL of a CR+NL line ending) get skipped
+        if ( lineLength > 0 && ( !lineOverflow || lineOverflowPolicy == OVERFLOW_TRUNCATE ) )
+        {
+            parseCommand( lineBuffer, lineLength, lineCommandEnd, lineCommandHash );
+        }
+
+        resetReceiveState();
+
+        // The command might have switched the codec, which applies to the rest of the bytes already
+        if ( getCodec() != this->receiveCodec )
+        {
+            receiveBytes( data + position, length - position );
+
+            return;
+        }
+    }
+}
+
+bool StreamCommander::matchFastCommand( char character )
+{
+    for ( int i = 0; i < numFastCommands; i++ )
+    {
+        if ( fastCommands[i].trigger == character )
+        {
+            fastCommands[i].callbackFunction( this );
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void StreamCommander::resetReceiveState()
+{
+    lineLength = 0;
+    lineOverflow = false;
+    lineCommandEnd = -1;
+    lineCommandHash = COMMAND_HASH_OFFSET;
+}
+
+void StreamCommander::dispatchCommandId( byte commandId )
+{
+    // Overlong commands get counted, and reported by the dispatching side, just like lines
+    if ( lineOverflow )
+    {
+        numOverflowedLines = numOverflowedLines + 1;
+    }
+
+    if ( !lineOverflow || lineOverflowPolicy == OVERFLOW_TRUNCATE )
+    {
+        // Binary arguments may contain zero bytes, so they get taken over by their length instead of up to the first zero,
+        // and moved on from here, since copying a String stops at the first zero on some cores
+        String arguments;
+        arguments.concat( lineBuffer, lineLength );
+
+        // Command IDs are the indices in the registry, as listed by the schema
+        if ( commandId >= getNumCommands() )
+        {
+            queueCommand( String( commandId ), static_cast<String &&>( arguments ), hashCommand( String( commandId ) ) );
+        }
+        else
+        {
+            queueCommand( *(commands[commandId].command), static_cast<String &&>( arguments ), commands[commandId].hash );
+        }
+    }
+
+    resetReceiveState();
+}
+
+int StreamCommander::appendToLine( const char * data, int length )
+{
+    int capacity = max( maxLineLength - lineLength, 0 );
+
+    // Everything beyond the maximum line length gets dropped
+    if ( length > capacity )
+    {
+        lineOverflow = true;
+        length = capacity;
+    }
+
+    memcpy( lineBuffer + lineLength, data, length );
+    lineLength += length;
+
+    return length;
+}
+
+void StreamCommander::setMaxLineLength( int maxLineLength )
+{
+    // Check if the maximum line length fits into our line buffer
+    if ( maxLineLength < 1 || maxLineLength > LINE_BUFFER_SIZE )
+    {
+        sendError( "Max line length has to be between 1 and " + String( LINE_BUFFER_SIZE ) + "." );
+
+        return;
+    }
+
+    this->maxLineLength = maxLineLength;
+}
+
+int StreamCommander::getMaxLineLength()
+{
+    return this->maxLineLength;
+}
+
+void StreamCommander::setLineOverflowPolicy( LineOverflowPolicy lineOverflowPolicy )
+{
+    this->lineOverflowPolicy = lineOverflowPolicy;
+}
+
+StreamCommander::LineOverflowPolicy StreamCommander::getLineOverflowPolicy()
+{
+    return this->lineOverflowPolicy;
+}
+
+int StreamCommander::findStopByte( const char * data, int length, const char * stopBytes, int numStopBytes )
+{
+    int position = 0;
+
+    #if UINTPTR_MAX > 0xFFFF
+    // Check a whole word at once: XOR-ing a word with a stop byte repeated in every byte zeroes the bytes which equal the stop byte,
+    // and ( x - 0x0101.. ) & ~x & 0x8080.. is non-zero if and only if a word x contains a zero byte.
+    // Only the word which contains a stop byte gets checked byte by byte afterwards.
+    typedef uintptr_t Word;
+    const Word LOW_BITS = ~(Word) 0 / 0xFF;
+    const Word HIGH_BITS = LOW_BITS * 0x80;
+
+    for ( ; position + (int) sizeof( Word ) <= length; position += sizeof( Word ) )
+    {
+        Word word;
+        Word found = 0;
+
+        memcpy( &word, data + position, sizeof( Word ) ); // Unaligned load
+
+        for ( int i = 0; i < numStopBytes; i++ )
+        {
+            Word difference = word ^ ( LOW_BITS * (byte) stopBytes[i] );
+            found |= ( difference - LOW_BITS ) & ~difference & HIGH_BITS;
+        }
+
+        if ( found )
+        {
+            break;
+        }
+    }
+    #endif
+
+    for ( ; position < length; position++ )
+    {
+        for ( int i = 0; i < numStopBytes; i++ )
+        {
+            if ( data[position] == stopBytes[i] )
+            {
+                return position;
+            }
+        }
+    }
+
+    return length;
+}
+
+void StreamCommander::fetchCommand()
+{
+    receiveCommands();
+    dispatchCommands();
+}
+
+void StreamCommander::receiveCommands()
+{
+    Stream * streamInstance = getStreamInstance();
+
+    transmitMessages();
+    queueHeldCommand();
+
+    SpanTransport * spanTransport = getSpanTransport();
+
+    // Scan the received bytes right where the transport keeps them
+    if ( spanTransport != nullptr )
+    {
+        const char * span;
+        int length;
+
+        while ( ( span = spanTransport->peekSpan( length ) ) != nullptr && length > 0 )
+        {
+            receiveBytes( span, length );
+            spanTransport->consumeSpan( length );
+        }
+
+        return;
+    }
+
+    // Feed everything which is available into our receive state machine chunk by chunk; incomplete lines are kept until the next call
+    // Only as many bytes as are available get requested, so readBytes() never has to wait for its' timeout
+    char buffer[RECEIVE_CHUNK_SIZE];
+    int available = streamInstance->available();
+
+    while ( available > 0 )
+    {
+        int length = streamInstance->readBytes( buffer, min( available, RECEIVE_CHUNK_SIZE ) );
+
+        if ( length <= 0 )
+        {
+            break;
+        }
+
+        receiveBytes( buffer, length );
+        available -= length;
+
+        // Pick up bytes which have arrived in the meantime
+        if ( available <= 0 )
+        {
+            available = streamInstance->available();
+        }
+    }
+}
+
+void StreamCommander::queueHeldCommand()
+{
+    if ( !this->commandHeld || commandQueue.isFull() )
+    {
+        return;
+    }
+
+    pushCommand( commandQueue, static_cast<String &&>( heldCommand.command ), static_cast<String &&>( heldCommand.arguments ), heldCommand.hash );
+    this->commandHeld = false;
+}
+
+void StreamCommander::setSpanTransport( SpanTransport * spanTransport )
+{
+    this->spanTransport = spanTransport;
+}
+
+SpanTransport * StreamCommander::getSpanTransport()
+{
+    return this->spanTransport;
+}
+
+void StreamCommander::dispatchCommands()
+{
+    // Report commands which have been dropped by the receiving side, since it must not send messages itself in split mode
+    byte numDroppedCommands = getNumDroppedCommands();
+
+    if ( numDroppedCommands != this->numReportedDroppedCommands )
+    {
+        sendError( "Command queue full, dropped " + String( (byte) ( numDroppedCommands - this->numReportedDroppedCommands ) ) + " command(s) (COMMAND_QUEUE_SIZE = " + String( COMMAND_QUEUE_SIZE ) + ")." );
+        this->numReportedDroppedCommands = numDroppedCommands;
+    }
+
+    byte numOverflowedLines = this->numOverflowedLines;
+
+    if ( numOverflowedLines != this->numReportedOverflowedLines )
+    {
+        sendError( "Line too long, " + String( getLineOverflowPolicy() == OVERFLOW_TRUNCATE ? "truncated " : "discarded " ) + String( (byte) ( numOverflowedLines - this->numReportedOverflowedLines ) ) + " line(s) (max line length = " + String( getMaxLineLength() ) + ")." );
+        this->numReportedOverflowedLines = numOverflowedLines;
+    }
+
+    processCodecFallback();
+    processStatusSnapshot();
+    processStatusProvider();
+    processPendingCommands();
+    processQueuedCommands();
+    processTransfer();
+}
+
+void StreamCommander::setCodec( Codec * codec )
+{
+    switchCodec( codec != nullptr ? codec : &textCodec, true );
+}
+
+Codec * StreamCommander::getCodec()
+{
+    return this->codec;
+}
+
+void StreamCommander::addCodec( Codec * codec )
+{
+    if ( numCodecs >= MAX_CODECS )
+    {
+        sendError( "Too many codecs." );
+        return;
+    }
+
+    codecs[numCodecs++] = codec;
+}
+
+void StreamCommander::setModeFallbackTimeout( unsigned long modeFallbackTimeout )
+{
+    this->modeFallbackTimeout = modeFallbackTimeout;
+}
+
+unsigned long StreamCommander::getModeFallbackTimeout()
+{
+    return this->modeFallbackTimeout;
+}
+
+void StreamCommander::switchCodec( Codec * codec, bool confirmed )
+{
+    this->codecTime = millis();
+    setCodecConfirmed( confirmed );
+    this->codec = codec;
+}
+
+void StreamCommander::setCodecConfirmed( bool codecConfirmed )
+{
+    #if defined( __AVR__ )
+    // Single core, and byte accesses are atomic anyway
+    *(volatile bool *) &this->codecConfirmed = codecConfirmed;
+    #else
+    __atomic_store_n( &this->codecConfirmed, codecConfirmed, __ATOMIC_RELEASE );
+    #endif
+}
+
+bool StreamCommander::isCodecConfirmed()
+{
+    #if defined( __AVR__ )
+    return *(volatile bool *) &this->codecConfirmed;
+    #else
+    return __atomic_load_n( &this->codecConfirmed, __ATOMIC_ACQUIRE );
+    #endif
+}
+
+void StreamCommander::processCodecFallback()
+{
+    if ( isCodecConfirmed() || millis() - this->codecTime < getModeFallbackTimeout() )
+    {
+        return;
+    }
+
+    // The host didn't follow the switch, so get back to the codec everyone understands
+    switchCodec( &textCodec, true );
+    sendMessage( TYPE_MODE, textCodec.getName() );
+}
+
+Codec * StreamCommander::getCodecByName( String name )
+{
+    for ( int i = 0; i < numCodecs; i++ )
+    {
+        if ( name.equals( codecs[i]->getName() ) )
+        {
+            return codecs[i];
+        }
+    }
+
+    return nullptr;
+}
+
+String StreamCommander::getCodecNames()
+{
+    String names = "";
+
+    for ( int i = 0; i < numCodecs; i++ )
+    {
+        if ( i > 0 )
+        {
+            names += CODEC_NAME_DELIMITER;
+        }
+
+        names += codecs[i]->getName();
+    }
+
+    return names;
+}
+
+void StreamCommander::setSplitMode( bool splitMode )
+{
+    #if STREAMCOMMANDER_SPLIT_MODE
+    this->splitMode = splitMode;
+    #else
+    if ( splitMode )
+    {
+        sendError( F( "Split mode isn't available (STREAMCOMMANDER_SPLIT_MODE = 0)." ) );
+    }
+    #endif
+}
+
+bool StreamCommander::isSplitMode()
+{
+    #if STREAMCOMMANDER_SPLIT_MODE
+    return this->splitMode;
+    #else
+    return false;
+    #endif
+}
+
+void StreamCommander::setQueuedTransmit( bool queuedTransmit )
+{
+    #if STREAMCOMMANDER_QUEUED_TRANSMIT
+    this->queuedTransmit = queuedTransmit;
+    #else
+    if ( queuedTransmit )
+    {
+        sendError( F( "Queued transmit isn't available (STREAMCOMMANDER_QUEUED_TRANSMIT = 0)." ) );
+    }
+    #endif
+}
+
+bool StreamCommander::isQueuedTransmit()
+{
+    #if STREAMCOMMANDER_QUEUED_TRANSMIT
+    return this->queuedTransmit || isSplitMode();
+    #else
+    return false;
+    #endif
+}
+
+unsigned int StreamCommander::getNumDroppedMessages()
+{
+    #if STREAMCOMMANDER_QUEUED_TRANSMIT
+    return transmitQueue.getNumDropped();
+    #else
+    return 0;
+    #endif
+}
+
+#if STREAMCOMMANDER_TELEMETRY
+void StreamCommander::sendTelemetry( const int32_t * values, byte numValues )
+{
+    if ( numValues > MAX_TELEMETRY_VALUES )
+    {
+        sendError( "Too many telemetry values (max. " + String( MAX_TELEMETRY_VALUES ) + ")." );
+
+        return;
+    }
+
+    // Differences can't be applied by the host if it has missed a sample, so every dropped message gets followed by a keyframe
+    unsigned int numDroppedMessages = getNumDroppedMessages();
+    bool keyframe = this->telemetryKeyframeRequested || numValues != this->numTelemetryValues || numDroppedMessages != this->telemetryDroppedMessages || this->telemetrySamples >= this->telemetryKeyframeInterval;
+
+    if ( keyframe )
+    {
+        this->telemetrySamples = 0;
+    }
+
+    char buffer[TELEMETRY_BUFFER_SIZE];
+    int length = 0;
+    buffer[length++] = ( keyframe ? TELEMETRY_KEYFRAME : 0 ) | numValues;
+    buffer[length++] = this->telemetrySequence++;
+
+    for ( byte i = 0; i < numValues; i++ )
+    {
+        // Differences wrap around like the values themselves, so the host gets the exact values back by adding them up modulo 2^32
+        uint32_t difference = keyframe ? (uint32_t) values[i] : (uint32_t) values[i] - (uint32_t) this->telemetryValues[i];
+
+        this->telemetryValues[i] = values[i];
+        length += encodeZigzagVarint( buffer + length, (int32_t) difference );
+    }
+
+    this->numTelemetryValues = numValues;
+    this->telemetrySamples++;
+    this->telemetryKeyframeRequested = false;
+
+    sendMessage( TYPE_TELEMETRY, buffer, length, CONTENT_BINARY );
+
+    // If this message has been dropped itself, the next one has to be a keyframe
+    this->telemetryDroppedMessages = getNumDroppedMessages();
+}
+
+void StreamCommander::setTelemetryKeyframeInterval( unsigned int telemetryKeyframeInterval )
+{
+    this->telemetryKeyframeInterval = telemetryKeyframeInterval;
+}
+
+unsigned int StreamCommander::getTelemetryKeyframeInterval()
+{
+    return this->telemetryKeyframeInterval;
+}
+
+void StreamCommander::requestTelemetryKeyframe()
+{
+    this->telemetryKeyframeRequested = true;
+}
+
+int StreamCommander::encodeZigzagVarint( char * buffer, int32_t value )
+{
+    // Move the sign to the lowest bit, so small negative values get small as well
+    uint32_t zigzag = ( (uint32_t) value << 1 ) ^ (uint32_t) ( value >> 31 );
+    int length = 0;
+
+    while ( zigzag >= 0x80 )
+    {
+        buffer[length++] = (char) ( ( zigzag & 0x7F ) | 0x80 );
+        zigzag >>= 7;
+    }
+
+    buffer[length++] = (char) zigzag;
+
+    return length;
+}
+#endif
+
+void StreamCommander::transmitMessages()
+{
+    #if STREAMCOMMANDER_QUEUED_TRANSMIT
+    Stream * streamInstance = getStreamInstance();
+    String * message;
+
+    while ( ( message = transmitQueue.front() ) != nullptr )
+    {
+        // Queued messages are already completely encoded, including their line ending
+        // The slot keeps its' String, and thus its' capacity, so encoding the next message into it usually doesn't need to allocate
+        streamInstance->print( *message );
+        transmitQueue.pop();
+    }
+    #endif
+}
+
+void StreamCommander::parseCommand( char * line, int length, int commandEnd, uint32_t hash )
+{
+    String command = "";
+    String arguments = "";
+
+    line[length] = '\0';
+
+    // If there is no command-delimiter, we can't parse any arguments (cause there probably are none)
+    if ( commandEnd < 0 )
+    {
+        command = line;
+    }
+    else
+    {
+        // Terminate the command at the delimiter, so both parts can be taken over as they are
+        line[commandEnd] = '\0';
+        command = line;
+        arguments = line + commandEnd + 1;
+    }
+
+    queueCommand( command, arguments, hash );
+}
+
+void StreamCommander::queueCommand( String command, String arguments, uint32_t hash )
+{
+    // Any command which makes it through the decoder confirms a negotiated switch of the codec, no matter which helpers the codec uses
+    setCodecConfirmed( true );
+
+    CommandContainer * container = getCommandContainer( command, hash );
+
+    // Priority commands skip the queue; in split mode they get queued separately, so they're still executed by the dispatching side
+    if ( container != nullptr && container->priority )
+    {
+        if ( !isSplitMode() )
+        {
+            executeCommand( command, static_cast<String &&>( arguments ), hash );
+
+            return;
+        }
+
+        #if STREAMCOMMANDER_SPLIT_MODE
+        // Dropped commands get counted by the queue, and reported by the dispatching side
+        pushCommand( priorityQueue, command, static_cast<String &&>( arguments ), hash );
+        #endif
+    }
+    else
+    {
+        // Reading goes on while the command queue is full, so priority and fast commands behind it don't have to wait.
+        // A single regular command gets held back until there is room again; further ones get dropped, and reported by the dispatching side
+        queueHeldCommand();
+
+        if ( !this->commandHeld && !commandQueue.isFull() )
+        {
+            pushCommand( commandQueue, command, static_cast<String &&>( arguments ), hash );
+        }
+        else if ( !this->commandHeld )
+        {
+            heldCommand.command = static_cast<String &&>( command );
+            heldCommand.arguments = static_cast<String &&>( arguments );
+            heldCommand.hash = hash;
+            this->commandHeld = true;
+        }
+        else
+        {
+            commandQueue.drop();
+        }
+    }
+}
+
+template <unsigned int SIZE>
+bool StreamCommander::pushCommand( SpscQueue<QueuedCommand, SIZE> & queue, String command, String arguments, uint32_t hash )
+{
+    QueuedCommand * queuedCommand = queue.reserve();
+
+    if ( queuedCommand == nullptr )
+    {
+        return false;
+    }
+
+    // The parameters are our own copies, so they can be moved into the slot
+    queuedCommand->command = static_cast<String &&>( command );
+    queuedCommand->hash = hash;
+    queuedCommand->arguments = static_cast<String &&>( arguments );
+    queue.push();
+
+    return true;
+}
+
+template <unsigned int SIZE>
+bool StreamCommander::executeQueuedCommand( SpscQueue<QueuedCommand, SIZE> & queue )
+{
+    QueuedCommand * queuedCommand = queue.front();
+
+    if ( queuedCommand == nullptr )
+    {
+        return false;
+    }
+
+    // Move the command out of the queue first, so the receiving side can reuse the slot while the callback runs
+    // Moving hands over the buffers without copying them, and leaves the Strings in the slot empty
+    String command = static_cast<String &&>( queuedCommand->command );
+    String arguments = static_cast<String &&>( queuedCommand->arguments );
+    uint32_t hash = queuedCommand->hash;
+
+    queue.pop();
+
+    executeCommand( command, static_cast<String &&>( arguments ), hash );
+
+    return true;
+}
+
+void StreamCommander::processQueuedCommands()
+{
+    #if STREAMCOMMANDER_SPLIT_MODE
+    // All priority commands get executed, but only the oldest regular command, so a newly arriving priority command never has to wait for more than one regular one
+    while ( executeQueuedCommand( priorityQueue ) );
+    #endif
+
+    executeQueuedCommand( commandQueue );
+}
+
+int StreamCommander::getNumQueuedCommands()
+{
+    #if STREAMCOMMANDER_SPLIT_MODE
+    return commandQueue.getLength() + priorityQueue.getLength() + ( this->commandHeld ? 1 : 0 );
+    #else
+    return commandQueue.getLength() + ( this->commandHeld ? 1 : 0 );
+    #endif
+}
+
+byte StreamCommander::getNumDroppedCommands()
+{
+    #if STREAMCOMMANDER_SPLIT_MODE
+    return commandQueue.getNumDropped() + priorityQueue.getNumDropped();
+    #else
+    return commandQueue.getNumDropped();
+    #endif
+}
+
+void StreamCommander::setTransferCallbacks( TransferReadFunction transferReadFunction, TransferWriteFunction transferWriteFunction )
+{
+    this->transferReadFunction = transferReadFunction;
+    this->transferWriteFunction = transferWriteFunction;
+}
+
+bool StreamCommander::isTransferring()
+{
+    return this->transferDirection != TRANSFER_NONE;
+}
+
+String StreamCommander::getTransferName()
+{
+    return this->transferName;
+}
+
+void StreamCommander::abortTransfer()
+{
+    if ( isTransferring() )
+    {
+        sendMessage( TYPE_TRANSFER, "aborted " + getTransferName() );
+        stopTransfer();
+    }
+}
+
+void StreamCommander::setTransferChunkSize( int transferChunkSize )
+{
+    if ( isTransferring() )
+    {
+        sendError( F( "Transfer parameters can't be changed during a transfer." ) );
+
+        return;
+    }
+
+    if ( transferChunkSize < 1 || transferChunkSize > MAX_TRANSFER_CHUNK_SIZE )
+    {
+        sendError( "Transfer chunk size has to be between 1 and " + String( MAX_TRANSFER_CHUNK_SIZE ) + "." );
+
+        return;
+    }
+
+    this->transferChunkSize = transferChunkSize;
+}
+
+int StreamCommander::getTransferChunkSize()
+{
+    return this->transferChunkSize;
+}
+
+void StreamCommander::setTransferWindowSize( int transferWindowSize )
+{
+    if ( isTransferring() )
+    {
+        sendError( F( "Transfer parameters can't be changed during a transfer." ) );
+
+        return;
+    }
+
+    if ( transferWindowSize < 1 )
+    {
+        sendError( F( "Transfer window size has to be at least 1." ) );
+
+        return;
+    }
+
+    this->transferWindowSize = transferWindowSize;
+}
+
+int StreamCommander::getTransferWindowSize()
+{
+    return this->transferWindowSize;
+}
+
+void StreamCommander::startTransfer( TransferDirection direction, String name, unsigned long size )
+{
+    int chunkSize = getTransferChunkSize();
+
+    // Chunks of push-transfers arrive as lines, so they get as small as the maximum line length requires
+    if ( direction == TRANSFER_PUSH )
+    {
+        chunkSize = min( chunkSize, ( getMaxLineLength() - TRANSFER_PUSH_LINE_OVERHEAD ) / 2 );
+    }
+
+    if ( chunkSize < 1 )
+    {
+        sendError( "Max line length too short for push-transfers (at least " + String( TRANSFER_PUSH_LINE_OVERHEAD + 2 ) + " characters)." );
+
+        return;
+    }
+
+    this->transferActiveChunkSize = chunkSize;
+    this->transferDirection = direction;
+    this->transferName = name;
+    this->transferSize = size;
+    this->transferSequence = 0;
+    this->transferAcknowledged = 0;
+    this->transferEndSequence = 0;
+    this->transferEndReached = false;
+    this->transferLastActivity = millis();
+
+    // Announce the transfer parameters, so the host knows how to split/expect the chunks
+    Print & message = beginMessage( TYPE_TRANSFER );
+    message.print( direction == TRANSFER_PUSH ? COMMAND_PUSH : COMMAND_PULL );
+    message.print( TRANSFER_DELIMITER );
+    message.print( name );
+    message.print( TRANSFER_DELIMITER );
+    message.print( this->transferActiveChunkSize );
+    message.print( TRANSFER_DELIMITER );
+    message.print( getTransferWindowSize() );
+    endMessage();
+}
+
+void StreamCommander::stopTransfer()
+{
+    this->transferDirection = TRANSFER_NONE;
+    this->transferName = "";
+}
+
+void StreamCommander::processTransfer()
+{
+    if ( this->transferDirection != TRANSFER_PULL )
+    {
+        return;
+    }
+
+    // Go back to the first unacknowledged chunk if the host didn't acknowledge anything for too long (e.g. because a chunk got lost)
+    if ( this->transferAcknowledged < this->transferSequence && millis() - this->transferLastActivity > TRANSFER_RETRY_TIMEOUT )
+    {
+        this->transferSequence = this->transferAcknowledged;
+        this->transferEndReached = false;
+        this->transferLastActivity = millis();
+    }
+
+    // Send as many chunks as the window allows; the data is read again on retransmission, so no chunks have to be buffered
+    while ( !this->transferEndReached && this->transferSequence < this->transferAcknowledged + getTransferWindowSize() )
+    {
+        int length = sendChunk( this->transferSequence );
+
+        if ( length < 0 )
+        {
+            sendError( "Reading transfer '" + getTransferName() + "' failed." );
+            abortTransfer();
+
+            return;
+        }
+
+        // An empty or partial chunk marks the end of the data
+        if ( length < this->transferActiveChunkSize )
+        {
+            this->transferEndReached = true;
+            this->transferEndSequence = this->transferSequence + ( length > 0 ? 1 : 0 );
+            this->transferSize = this->transferSequence * this->transferActiveChunkSize + length;
+
+            // An empty chunk doesn't need to be acknowledged
+            if ( length == 0 )
+            {
+                break;
+            }
+        }
+
+        this->transferSequence++;
+    }
+
+    if ( this->transferEndReached && this->transferAcknowledged >= this->transferEndSequence )
+    {
+        sendMessage( TYPE_TRANSFER, "done " + String( this->transferSize ) );
+        stopTransfer();
+    }
+}
+
+int StreamCommander::sendChunk( unsigned long sequence )
+{
+    // Leave room for the sequence number and the checksum around the data, so binary chunks can be sent from the buffer as they are
+    byte buffer[TRANSFER_SEQUENCE_BYTES + MAX_TRANSFER_CHUNK_SIZE + TRANSFER_CHECKSUM_BYTES];
+    byte * data = buffer + TRANSFER_SEQUENCE_BYTES;
+    int chunkSize = this->transferActiveChunkSize;
+    int length = this->transferReadFunction( sequence * chunkSize, data, chunkSize, this );
+
+    if ( length < 0 || length > chunkSize )
+    {
+        return -1;
+    }
+
+    if ( length == 0 )
+    {
+        return 0;
+    }
+
+    uint16_t checksum = calculateChecksum( data, length );
+
+    if ( getCodec()->isBinary() )
+    {
+        // Binary codecs carry the raw data: "<sequence><data><checksum>", with both numbers big endian
+        for ( int i = 0; i < TRANSFER_SEQUENCE_BYTES; i++ )
+        {
+            buffer[i] = sequence >> ( ( TRANSFER_SEQUENCE_BYTES - 1 - i ) * 8 );
+        }
+
+        data[length] = checksum >> 8;
+        data[length + 1] = checksum;
+
+        sendMessage( TYPE_CHUNK, (const char *) buffer, TRANSFER_SEQUENCE_BYTES + length + TRANSFER_CHECKSUM_BYTES, CONTENT_BINARY );
+    }
+    else
+    {
+        // Stream the chunk as "<sequence> <hex-data> <checksum>" without building a String
+        Print & message = beginMessage( TYPE_CHUNK );
+        message.print( sequence );
+        message.print( TRANSFER_DELIMITER );
+
+        for ( int i = 0; i < length; i++ )
+        {
+            printHex( message, data[i], 2 );
+        }
+
+        message.print( TRANSFER_DELIMITER );
+        printHex( message, checksum, 4 );
+        endMessage();
+    }
+
+    this->transferLastActivity = millis();
+
+    return length;
+}
+
+void StreamCommander::receiveChunk( String arguments )
+{
+    int dataStart = arguments.indexOf( TRANSFER_DELIMITER );
+    int checksumStart = arguments.indexOf( TRANSFER_DELIMITER, dataStart + 1 );
+    int dataLength = ( checksumStart - dataStart - 1 ) / 2;
+
+    if ( dataStart <= 0 || checksumStart < 0 || dataLength > this->transferActiveChunkSize )
+    {
+        sendError( F( "Malformed chunk." ) );
+
+        return;
+    }
+
+    String sequenceText = arguments.substring( 0, dataStart );
+    unsigned long sequence = sequenceText.toInt();
+    byte buffer[MAX_TRANSFER_CHUNK_SIZE];
+    bool valid = ( checksumStart - dataStart - 1 ) % 2 == 0 && isUnsignedNumber( sequenceText );
+
+    for ( int i = 0; i < dataLength && valid; i++ )
+    {
+        int high = hexToNibble( arguments.charAt( dataStart + 1 + i * 2 ) );
+        int low = hexToNibble( arguments.charAt( dataStart + 2 + i * 2 ) );
+
+        valid = high >= 0 && low >= 0;
+        buffer[i] = ( high << 4 ) | low;
+    }
+
+    long checksum = 0;
+
+    for ( unsigned int i = checksumStart + 1; i < arguments.length() && valid; i++ )
+    {
+        int nibble = hexToNibble( arguments.charAt( i ) );
+
+        valid = nibble >= 0;
+        checksum = ( checksum << 4 ) | nibble;
+    }
+
+    // Corrupted or out of order chunks get rejected; the host has to resend everything from the expected chunk on (go-back-N)
+    if ( !valid || checksum != calculateChecksum( buffer, dataLength ) || sequence > this->transferSequence )
+    {
+        sendMessage( TYPE_NAK, String( this->transferSequence ) );
+
+        return;
+    }
+
+    // A duplicate of an already written chunk only has to be acknowledged again
+    if ( sequence < this->transferSequence )
+    {
+        sendMessage( TYPE_ACK, String( this->transferSequence - 1 ) );
+
+        return;
+    }
+
+    if ( this->transferWriteFunction( sequence * this->transferActiveChunkSize, buffer, dataLength, this ) != dataLength )
+    {
+        sendError( "Writing transfer '" + getTransferName() + "' failed." );
+        abortTransfer();
+
+        return;
+    }
+
+    this->transferSequence++;
+    this->transferLastActivity = millis();
+    sendMessage( TYPE_ACK, String( sequence ) );
+
+    // All chunks but the last one are complete, so the transfer is done as soon as the announced size has been reached
+    if ( sequence * this->transferActiveChunkSize + dataLength >= this->transferSize )
+    {
+        sendMessage( TYPE_TRANSFER, "done " + String( this->transferSize ) );
+        stopTransfer();
+    }
+}
+
+uint16_t StreamCommander::calculateChecksum( const byte * data, int length )
+{
+    uint16_t crc = 0xFFFF;
+
+    for ( int i = 0; i < length; i++ )
+    {
+        crc ^= (uint16_t) data[i] << 8;
+
+        for ( int bit = 0; bit < 8; bit++ )
+        {
+            crc = ( crc & 0x8000 ) ? ( crc << 1 ) ^ 0x1021 : crc << 1;
+        }
+    }
+
+    return crc;
+}
+
+int StreamCommander::hexToNibble( char character )
+{
+    if ( character >= '0' && character <= '9' )
+    {
+        return character - '0';
+    }
+    else if ( character >= 'a' && character <= 'f' )
+    {
+        return character - 'a' + 10;
+    }
+    else if ( character >= 'A' && character <= 'F' )
+    {
+        return character - 'A' + 10;
+    }
+
+    return -1;
+}
+
+void StreamCommander::printHex( Print & output, unsigned long value, int digits )
+{
+    static const char HEX_DIGITS[] = "0123456789abcdef";
+
+    for ( int shift = ( digits - 1 ) * 4; shift >= 0; shift -= 4 )
+    {
+        output.print( HEX_DIGITS[( value >> shift ) & 0x0F] );
+    }
+}
+
+void StreamCommander::sendMessage( String type, String content )
+{
+    int index = getMessageTypeIndex( type );
+
+    if ( index >= 0 )
+    {
+        sendMessage( index, content.c_str(), content.length() );
+
+        return;
+    }
+
+    // Message types which haven't been registered get their header rendered on the fly
+    sendEncodedMessage( UNREGISTERED_MESSAGE_TYPE, type + getMessageDelimiter(), content.c_str(), content.length() );
+}
+
+void StreamCommander::sendMessage( byte messageTypeId, String content )
+{
+    sendMessage( messageTypeId, content.c_str(), content.length() );
+}
+
+void StreamCommander::sendMessage( byte messageTypeId, const char * content, int length, ContentFormat format )
+{
+    // In case a message gets sent before init()
+    addStandardMessageTypes();
+
+    if ( messageTypeId >= numMessageTypes )
+    {
+        sendError( "Message type " + String( messageTypeId ) + " not registered." );
+
+        return;
+    }
+
+    sendEncodedMessage( messageTypeId, messageHeaders[messageTypeId], content, length, format );
+}
+
+void StreamCommander::sendEncodedMessage( byte messageTypeId, const String & header, const char * content, int length, ContentFormat format )
+{
+    Codec * codec = getCodec();
+
+    if ( !isQueuedTransmit() )
+    {
+        encodeMessage( codec, *getStreamInstance(), messageTypeId, header, content, length, format );
+
+        return;
+    }
+
+    #if STREAMCOMMANDER_QUEUED_TRANSMIT
+    String * message = transmitQueue.reserve();
+
+    // Senders never wait for the stream; if the queue is full, the message gets dropped (and counted by the queue)
+    if ( message == nullptr )
+    {
+        return;
+    }
+
+    // Encode the whole message into the claimed slot, so it can't interleave with messages of other senders
+    // Clearing keeps the capacity of the String, which usually suffices for the next message already
+    *message = "";
+    message->reserve( header.length() + length + 8 );
+
+    StringPrint output( *message );
+    encodeMessage( codec, output, messageTypeId, header, content, length, format );
+
+    transmitQueue.push( message );
+    #endif
+}
+
+void StreamCommander::encodeMessage( Codec * codec, Print & output, byte messageTypeId, const String & header, const char * content, int length, ContentFormat format )
+{
+    if ( format == CONTENT_STRUCTURED )
+    {
+        codec->encodeStructuredMessage( output, messageTypeId, header, content, length );
+
+        return;
+    }
+
+    if ( format == CONTENT_BINARY )
+    {
+        codec->encodeBinaryMessage( output, messageTypeId, header, content, length );
+
+        return;
+    }
+
+    codec->encodeMessage( output, messageTypeId, header, content, length );
+}
+
+Print & StreamCommander::beginMessage( String type )
+{
+    int index = getMessageTypeIndex( type );
+
+    if ( index < 0 )
+    {
+        return beginMessageWithHeader( UNREGISTERED_MESSAGE_TYPE, type + getMessageDelimiter() );
+    }
+
+    return beginMessageWithHeader( index, messageHeaders[index] );
+}
+
+Print & StreamCommander::beginMessage( byte messageTypeId )
+{
+    addStandardMessageTypes();
+
+    if ( messageTypeId >= numMessageTypes )
+    {
+        sendError( "Message type " + String( messageTypeId ) + " not registered." );
+
+        return beginMessageWithHeader( UNREGISTERED_MESSAGE_TYPE, String( messageTypeId ) + getMessageDelimiter() );
+    }
+
+    return beginMessageWithHeader( messageTypeId, messageHeaders[messageTypeId] );
+}
+
+Print & StreamCommander::beginMessageWithHeader( byte messageTypeId, const String & header )
+{
+    this->messageFormat = CONTENT_TEXT;
+
+    Codec * codec = getCodec();
+    Stream * streamInstance = getStreamInstance();
+
+    // Stream the content right away, unless messages get queued or the codec needs the whole content in advance
+    if ( !isQueuedTransmit() && codec->encodeBegin( *streamInstance, messageTypeId, header ) )
+    {
+        this->messageCodec = codec;
+
+        return *streamInstance;
+    }
+
+    this->messageCodec = nullptr;
+    this->messageTypeId = messageTypeId;
+    this->messageHeader = messageTypeId == UNREGISTERED_MESSAGE_TYPE ? header : String( "" );
+    messageBuffer.content = "";
+
+    return messageBuffer;
+}
+
+Print & StreamCommander::beginResponse()
+{
+    return beginMessage( TYPE_RESPONSE );
+}
+
+MessagePackWriter & StreamCommander::beginStructuredMessage( byte messageTypeId )
+{
+    addStandardMessageTypes();
+
+    // The content always gets collected, since codecs encode it as a whole
+    this->messageCodec = nullptr;
+    this->messageFormat = CONTENT_STRUCTURED;
+    this->messageTypeId = messageTypeId;
+    this->messageHeader = "";
+    messageBuffer.content = "";
+
+    if ( messageTypeId >= numMessageTypes )
+    {
+        sendError( "Message type " + String( messageTypeId ) + " not registered." );
+
+        this->messageTypeId = UNREGISTERED_MESSAGE_TYPE;
+        this->messageHeader = String( messageTypeId ) + getMessageDelimiter();
+    }
+
+    return messageWriter;
+}
+
+MessagePackWriter & StreamCommander::beginStructuredResponse()
+{
+    return beginStructuredMessage( TYPE_RESPONSE );
+}
+
+JsonWriter & StreamCommander::beginJsonMessage( byte messageTypeId )
+{
+    messageJsonWriter.reset( beginMessage( messageTypeId ) );
+
+    return messageJsonWriter;
+}
+
+JsonWriter & StreamCommander::beginJsonResponse()
+{
+    return beginJsonMessage( TYPE_RESPONSE );
+}
+
+void StreamCommander::endMessage()
+{
+    if ( this->messageCodec != nullptr )
+    {
+        this->messageCodec->encodeEnd( *getStreamInstance() );
+
+        return;
+    }
+
+    const String & header = messageTypeId == UNREGISTERED_MESSAGE_TYPE ? messageHeader : messageHeaders[messageTypeId];
+    sendEncodedMessage( messageTypeId, header, messageBuffer.content.c_str(), messageBuffer.content.length(), this->messageFormat );
+    messageBuffer.content = "";
+}
+
+int StreamCommander::formatNumber( char * buffer, int64_t value, byte decimals )
+{
+    // The digits get written backwards from the end of a scratch buffer
+    char digits[NUMBER_BUFFER_SIZE];
+    int position = NUMBER_BUFFER_SIZE;
+    int numDigits = 0;
+    bool negative = value < 0;
+    uint64_t magnitude = negative ? -(uint64_t) value : (uint64_t) value;
+
+    // 64 bit divisions are expensive on small MCUs, so they're only used until the rest fits into 32 bits
+    while ( magnitude > 0xFFFFFFFFUL )
+    {
+        uint64_t quotient = magnitude / 10;
+        digits[--position] = '0' + (char) ( magnitude - quotient * 10 );
+        magnitude = quotient;
+
+        if ( ++numDigits == decimals )
+        {
+            digits[--position] = '.';
+        }
+    }
+
+    uint32_t rest = (uint32_t) magnitude;
+
+    // Write at least one digit before the decimal point
+    do
+    {
+        uint32_t quotient = rest / 10;
+        digits[--position] = '0' + (char) ( rest - quotient * 10 );
+        rest = quotient;
+
+        if ( ++numDigits == decimals )
+        {
+            digits[--position] = '.';
+        }
+    }
+    while ( rest > 0 || numDigits <= decimals );
+
+    if ( negative )
+    {
+        digits[--position] = '-';
+    }
+
+    int length = NUMBER_BUFFER_SIZE - position;
+    memcpy( buffer, digits + position, length );
+    buffer[length] = '\0';
+
+    return length;
+}
+
+bool StreamCommander::scaleNumber( double value, byte decimals, int64_t & scaledValue )
+{
+    double scaled = value;
+
+    for ( byte i = 0; i < decimals; i++ )
+    {
+        scaled *= 10;
+    }
+
+    // Also fails for NaN, which doesn't compare to anything
+    if ( !( scaled > -9.2e18 && scaled < 9.2e18 ) )
+    {
+        return false;
+    }
+
+    scaledValue = (int64_t) ( scaled < 0 ? scaled - 0.5 : scaled + 0.5 );
+
+    return true;
+}
+
+int StreamCommander::formatNumber( char * buffer, double value, byte decimals )
+{
+    if ( decimals > MAX_DECIMALS )
+    {
+        decimals = MAX_DECIMALS;
+    }
+
+    int64_t scaledValue;
+
+    if ( scaleNumber( value, decimals, scaledValue ) )
+    {
+        return formatNumber( buffer, scaledValue, decimals );
+    }
+
+    // NaN is the only value which doesn't equal itself
+    if ( value != value )
+    {
+        strcpy( buffer, "nan" );
+
+        return 3;
+    }
+
+    bool negative = value < 0;
+    double magnitude = negative ? -value : value;
+
+    // Infinity minus infinity is NaN
+    if ( !( magnitude - magnitude == 0 ) )
+    {
+        strcpy( buffer, negative ? "-inf" : "inf" );
+
+        return negative ? 4 : 3;
+    }
+
+    // Numbers which are too large for a fixed-point number get written in scientific notation (e.g. 1.00e30), so no digits get lost
+    int exponent = 0;
+
+    while ( magnitude >= 10 )
+    {
+        magnitude /= 10;
+        exponent++;
+    }
+
+    int64_t mantissa = 0;
+    int64_t limit = 10;
+
+    scaleNumber( magnitude, decimals, mantissa );
+
+    for ( byte i = 0; i < decimals; i++ )
+    {
+        limit *= 10;
+    }
+
+    // Rounding might have carried over into another digit (e.g. 9.999 becomes 10.00)
+    if ( mantissa >= limit )
+    {
+        mantissa /= 10;
+        exponent++;
+    }
+
+    int length = formatNumber( buffer, negative ? -mantissa : mantissa, decimals );
+    buffer[length++] = 'e';
+    length += formatNumber( buffer + length, (int64_t) exponent, 0 );
+
+    return length;
+}
+
+int StreamCommander::formatValues( char * buffer, const int * values, byte numValues )
+{
+    int length = 0;
+
+    for ( byte i = 0; i < numValues; i++ )
+    {
+        if ( i > 0 )
+        {
+            buffer[length++] = VALUE_DELIMITER;
+        }
+
+        length += formatNumber( buffer + length, (int64_t) values[i], 0 );
+    }
+
+    buffer[length] = '\0';
+
+    return length;
+}
+
+int StreamCommander::formatValues( char * buffer, const int64_t * values, byte numValues, byte decimals )
+{
+    int length = 0;
+
+    for ( byte i = 0; i < numValues; i++ )
+    {
+        if ( i > 0 )
+        {
+            buffer[length++] = VALUE_DELIMITER;
+        }
+
+        length += formatNumber( buffer + length, values[i], decimals );
+    }
+
+    buffer[length] = '\0';
+
+    return length;
+}
+
+int StreamCommander::formatValues( char * buffer, const float * values, byte numValues, byte decimals )
+{
+    int length = 0;
+
+    for ( byte i = 0; i < numValues; i++ )
+    {
+        if ( i > 0 )
+        {
+            buffer[length++] = VALUE_DELIMITER;
+        }
+
+        length += formatNumber( buffer + length, (double) values[i], decimals );
+    }
+
+    buffer[length] = '\0';
+
+    return length;
+}
+
+void StreamCommander::sendResponse( String response )
+{
+    sendMessage( TYPE_RESPONSE, response );
+}
+
+void StreamCommander::sendResponse( int value )
+{
+    sendResponse( (long) value );
+}
+
+void StreamCommander::sendResponse( unsigned int value )
+{
+    sendResponse( (unsigned long) value );
+}
+
+void StreamCommander::sendResponse( long value )
+{
+    char buffer[NUMBER_BUFFER_SIZE];
+    int length = formatNumber( buffer, (int64_t) value, 0 );
+    sendMessage( TYPE_RESPONSE, buffer, length );
+}
+
+void StreamCommander::sendResponse( unsigned long value )
+{
+    // Where unsigned long has 64 bits, the largest values don't fit into a fixed-point number
+    if ( (uint64_t) value > (uint64_t) INT64_MAX )
+    {
+        sendResponse( String( value ) );
+
+        return;
+    }
+
+    char buffer[NUMBER_BUFFER_SIZE];
+    int length = formatNumber( buffer, (int64_t) value, 0 );
+    sendMessage( TYPE_RESPONSE, buffer, length );
+}
+
+void StreamCommander::sendResponse( double value, byte decimals )
+{
+    char buffer[NUMBER_BUFFER_SIZE];
+    int length = formatNumber( buffer, value, decimals );
+    sendMessage( TYPE_RESPONSE, buffer, length );
+}
+
+bool StreamCommander::checkNumValues( byte numValues )
+{
+    if ( numValues > MAX_VALUES )
+    {
+        sendError( "Too many values (" + String( numValues ) + "), only up to " + String( MAX_VALUES ) + " can be sent at once." );
+
+        return false;
+    }
+
+    return true;
+}
+
+void StreamCommander::sendResponse( const int * values, byte numValues )
+{
+    if ( !checkNumValues( numValues ) )
+    {
+        return;
+    }
+
+    char buffer[VALUES_BUFFER_SIZE];
+    int length = formatValues( buffer, values, numValues );
+    sendMessage( TYPE_RESPONSE, buffer, length );
+}
+
+void StreamCommander::sendResponse( const float * values, byte numValues, byte decimals )
+{
+    if ( !checkNumValues( numValues ) )
+    {
+        return;
+    }
+
+    char buffer[VALUES_BUFFER_SIZE];
+    int length = formatValues( buffer, values, numValues, decimals );
+    sendMessage( TYPE_RESPONSE, buffer, length );
+}
+
+void StreamCommander::sendInfo( String info )
+{
+    sendMessage( TYPE_INFO, info );
+}
+
+void StreamCommander::sendError( String error )
+{
+    sendMessage( TYPE_ERROR, error );
+}
+
+void StreamCommander::sendPing()
+{
+    sendMessage( TYPE_PING, PING_REPLY );
+}
+
+void StreamCommander::sendStatus()
+{
+    StatusProviderFunction statusProviderFunction = getStatusProvider();
+
+    if ( statusProviderFunction != nullptr )
+    {
+        // Let the provider update the status, which then gets sent because it has been requested
+        this->statusRequested = true;
+        statusProviderFunction( this );
+
+        if ( !this->statusRequested )
+        {
+            return;
+        }
+
+        // The provider didn't update the status, so the current one gets sent
+        this->statusRequested = false;
+    }
+
+    // The text of the status isn't kept while hashing, so it gets sent by the next updateStatus()
+    if ( isStatusHashing() && this->statusDecimals > MAX_DECIMALS && this->statusDecimals != STATUS_VALUES )
+    {
+        this->statusRequested = true;
+
+        return;
+    }
+
+    if ( this->statusDecimals == STATUS_STRUCTURED )
+    {
+        sendMessage( TYPE_STATUS, this->structuredStatus, this->statusLength, CONTENT_STRUCTURED );
+
+        return;
+    }
+
+    sendMessage( TYPE_STATUS, getStatus() );
+}
+
+void StreamCommander::sendId()
+{
+    sendMessage( TYPE_ID, getId() );
+}
+
+void StreamCommander::sendIsActive()
+{
+    sendMessage( TYPE_ACTIVE, String( isActive() ) );
+}
+
+void StreamCommander::sendEcho( String echo )
+{
+    sendMessage( TYPE_ECHO, echo );
+}
+
+void StreamCommander::sendCommands()
+{
+    sendMessage( TYPE_COMMANDS, getCommandList() );
+}
+
+void StreamCommander::sendSchema()
+{
+    // The schema gets streamed entry by entry, instead of being rendered into memory first
+    Print & message = beginMessage( TYPE_SCHEMA );
+    printHex( message, getSchemaHash(), 8 );
+    printSchema( message );
+    endMessage();
+}
+
+void StreamCommander::sendSchemaHash()
+{
+    Print & message = beginMessage( TYPE_SCHEMA );
+    printHex( message, getSchemaHash(), 8 );
+    endMessage();
+}
+
+void StreamCommander::commandActivate( String arguments, StreamCommander * instance )
+{
+    instance->setActive( true );
+}
+
+void StreamCommander::commandDeactivate( String arguments, StreamCommander * instance )
+{
+    instance->setActive( false );
+}
+
+void StreamCommander::commandIsActive( String arguments, StreamCommander * instance )
+{
+    instance->sendIsActive();
+}
+
+void StreamCommander::commandSetEcho( String arguments, StreamCommander * instance )
+{
+    arguments.trim();
+
+    if ( arguments.equals( "on" ) )
+    {
+        instance->setEchoCommands( true );
+    }
+    else if ( arguments.equals( "off" ) )
+    {
+        instance->setEchoCommands( false );
+    }
+}
+
+void StreamCommander::commandSetId( String id, StreamCommander * instance )
+{
+    id.trim();
+    instance->setId( id );
+}
+
+void StreamCommander::commandGetId( String arguments, StreamCommander * instance )
+{
+    instance->sendId();
+}
+
+void StreamCommander::commandPing( String arguments, StreamCommander * instance )
+{
     instance->sendPing();
 }
 
@@ -572,6 +3015,194 @@ void StreamCommander::commandListCommands( String arguments, StreamCommander * i
     instance->sendCommands();
 }
 
+void StreamCommander::commandSchema( String arguments, StreamCommander * instance )
+{
+    instance->sendSchema();
+}
+
+void StreamCommander::commandSchemaHash( String arguments, StreamCommander * instance )
+{
+    instance->sendSchemaHash();
+}
+
+void StreamCommander::commandMode( String mode, StreamCommander * instance )
+{
+    mode.trim();
+
+    // Capability handshake: list the registered codecs
+    if ( mode.length() == 0 )
+    {
+        instance->sendMessage( TYPE_MODE, instance->getCodecNames() );
+
+        return;
+    }
+
+    Codec * codec = instance->getCodecByName( mode );
+
+    if ( codec == nullptr )
+    {
+        instance->sendError( "Unknown mode '" + mode + "' (supported: " + instance->getCodecNames() + ")." );
+
+        return;
+    }
+
+    // The switch gets acknowledged in the current codec, so the host knows from where on the new one applies
+    instance->sendMessage( TYPE_MODE, codec->getName() );
+    instance->switchCodec( codec, codec == &instance->textCodec );
+}
+
+#if STREAMCOMMANDER_TELEMETRY
+void StreamCommander::commandKeyframe( String arguments, StreamCommander * instance )
+{
+    instance->requestTelemetryKeyframe();
+}
+#endif
+
+void StreamCommander::commandCancel( String tag, StreamCommander * instance )
+{
+    tag.trim();
+
+    // toInt() would turn anything which isn't a number into 0
+    if ( !isUnsignedNumber( tag ) )
+    {
+        instance->sendError( "Invalid tag '" + tag + "'." );
+
+        return;
+    }
+
+    // Tags are unsigned ints, so larger numbers must not wrap around onto another tag (e.g. 65537 onto 1 with 16 bit ints); strtoul() saturates instead of overflowing
+    unsigned long value = strtoul( tag.c_str(), nullptr, 10 );
+
+    if ( value != (unsigned int) value || !instance->cancelCommand( value ) )
+    {
+        instance->sendError( "No pending request with tag '" + tag + "'." );
+    }
+}
+
+bool StreamCommander::isUnsignedNumber( const String & text )
+{
+    if ( text.length() == 0 )
+    {
+        return false;
+    }
+
+    for ( unsigned int i = 0; i < text.length(); i++ )
+    {
+        if ( text.charAt( i ) < '0' || text.charAt( i ) > '9' )
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void StreamCommander::commandPush( String arguments, StreamCommander * instance )
+{
+    arguments.trim();
+    int sizeStart = arguments.indexOf( TRANSFER_DELIMITER );
+
+    if ( instance->transferWriteFunction == nullptr )
+    {
+        instance->sendError( F( "No transfer write callback set." ) );
+    }
+    else if ( sizeStart <= 0 )
+    {
+        instance->sendError( F( "Usage: push <name> <size>" ) );
+    }
+    else
+    {
+        instance->startTransfer( TRANSFER_PUSH, arguments.substring( 0, sizeStart ), arguments.substring( sizeStart + 1 ).toInt() );
+    }
+}
+
+void StreamCommander::commandPull( String arguments, StreamCommander * instance )
+{
+    arguments.trim();
+
+    if ( instance->transferReadFunction == nullptr )
+    {
+        instance->sendError( F( "No transfer read callback set." ) );
+    }
+    else
+    {
+        // The chunks get sent by processTransfer() on the following fetchCommand() calls
+        instance->startTransfer( TRANSFER_PULL, arguments, 0 );
+    }
+}
+
+void StreamCommander::commandChunk( String arguments, StreamCommander * instance )
+{
+    if ( instance->transferDirection != TRANSFER_PUSH )
+    {
+        instance->sendError( F( "No push-transfer running." ) );
+
+        return;
+    }
+
+    instance->receiveChunk( arguments );
+}
+
+void StreamCommander::commandAck( String arguments, StreamCommander * instance )
+{
+    if ( instance->transferDirection != TRANSFER_PULL )
+    {
+        return;
+    }
+
+    arguments.trim();
+
+    // toInt() would turn anything which isn't a number into 0, which would acknowledge the first chunk
+    if ( !isUnsignedNumber( arguments ) )
+    {
+        instance->sendError( "Invalid sequence '" + arguments + "'." );
+
+        return;
+    }
+
+    // Acknowledgements are cumulative: all chunks up to and including the given sequence number have been received
+    unsigned long acknowledged = arguments.toInt() + 1;
+
+    if ( acknowledged > instance->transferAcknowledged && acknowledged <= instance->transferSequence )
+    {
+        instance->transferAcknowledged = acknowledged;
+        instance->transferLastActivity = millis();
+    }
+}
+
+void StreamCommander::commandNak( String arguments, StreamCommander * instance )
+{
+    if ( instance->transferDirection != TRANSFER_PULL )
+    {
+        return;
+    }
+
+    arguments.trim();
+
+    // toInt() would turn anything which isn't a number into 0, which would resend everything
+    if ( !isUnsignedNumber( arguments ) )
+    {
+        instance->sendError( "Invalid sequence '" + arguments + "'." );
+
+        return;
+    }
+
+    // Go back to the requested chunk and resend everything from there on
+    unsigned long sequence = arguments.toInt();
+
+    if ( sequence >= instance->transferAcknowledged && sequence < instance->transferSequence )
+    {
+        instance->transferSequence = sequence;
+        instance->transferEndReached = false;
+        instance->transferLastActivity = millis();
+    }
+}
+
+void StreamCommander::commandAbort( String arguments, StreamCommander * instance )
+{
+    instance->abortTransfer();
+}
+
 void StreamCommander::addAllStandardCommands()
 {
     addCommand( COMMAND_ACTIVATE, commandActivate );
@@ -583,6 +3214,42 @@ void StreamCommander::addAllStandardCommands()
     addCommand( COMMAND_PING, commandPing );
     addCommand( COMMAND_GETSTATUS, commandGetStatus );
     addCommand( COMMAND_LISTCOMMANDS, commandListCommands );
+    addPriorityCommand( COMMAND_CANCEL, commandCancel );
+    addCommand( COMMAND_PUSH, commandPush );
+    addCommand( COMMAND_PULL, commandPull );
+    addPriorityCommand( COMMAND_CHUNK, commandChunk );
+    addPriorityCommand( COMMAND_ACK, commandAck );
+    addPriorityCommand( COMMAND_NAK, commandNak );
+    addPriorityCommand( COMMAND_ABORT, commandAbort );
+    addCommand( COMMAND_SCHEMA, commandSchema );
+    addCommand( COMMAND_SCHEMAHASH, commandSchemaHash );
+    addPriorityCommand( COMMAND_MODE, commandMode );
+    #if STREAMCOMMANDER_TELEMETRY
+    addCommand( COMMAND_KEYFRAME, commandKeyframe );
+    #endif
+
+    describeCommand( COMMAND_ACTIVATE, "", "active" );
+    describeCommand( COMMAND_DEACTIVATE, "", "active" );
+    describeCommand( COMMAND_ISACTIVE, "", "active" );
+    describeCommand( COMMAND_SETECHO, "w", "" );
+    describeCommand( COMMAND_SETID, "t", "id" );
+    describeCommand( COMMAND_GETID, "", "id" );
+    describeCommand( COMMAND_PING, "", "ping" );
+    describeCommand( COMMAND_GETSTATUS, "", "status" );
+    describeCommand( COMMAND_LISTCOMMANDS, "", "commands" );
+    describeCommand( COMMAND_CANCEL, "i", "cancelled,error" );
+    describeCommand( COMMAND_PUSH, "wi", "transfer,error" );
+    describeCommand( COMMAND_PULL, "w", "transfer,chunk,error" );
+    describeCommand( COMMAND_CHUNK, "ixx", "ack,nak,transfer,error" );
+    describeCommand( COMMAND_ACK, "i", "chunk,transfer,error" );
+    describeCommand( COMMAND_NAK, "i", "chunk,error" );
+    describeCommand( COMMAND_ABORT, "", "transfer" );
+    describeCommand( COMMAND_SCHEMA, "", "schema" );
+    describeCommand( COMMAND_SCHEMAHASH, "", "schema" );
+    describeCommand( COMMAND_MODE, "w", "mode,error" );
+    #if STREAMCOMMANDER_TELEMETRY
+    describeCommand( COMMAND_KEYFRAME, "", "" );
+    #endif
 }
 
 void StreamCommander::defaultCommand( String command, String arguments, StreamCommander * instance )
@@ -21,30 +21,214 @@
 #include <Arduino.h>
 #include <MessageTypes.hpp>
 
+#include "SpscQueue.hpp"
+#include "MpscQueue.hpp"
+#include "SpanTransport.hpp"
+#include "Codecs.hpp"
+#include "MessagePackWriter.hpp"
+#include "JsonWriter.hpp"
+
 #if __has_include("<EEPROM.h>")
 #include <EEPROM.h>
 #endif
 
+// Compile-time configuration, which can be overridden by compiler flags (e.g. -DSTREAMCOMMANDER_TELEMETRY=0), in order to save RAM on small boards
+// Split mode (see StreamCommander::setSplitMode()), including the queue of priority commands for the dispatching side
+#ifndef STREAMCOMMANDER_SPLIT_MODE
+#define STREAMCOMMANDER_SPLIT_MODE 1
+#endif
+
+// Queued transmit (see StreamCommander::setQueuedTransmit()), including the transmit queue; required by the split mode
+#ifndef STREAMCOMMANDER_QUEUED_TRANSMIT
+#define STREAMCOMMANDER_QUEUED_TRANSMIT 1
+#endif
+
+// Delta-encoded telemetry (see StreamCommander::sendTelemetry())
+#ifndef STREAMCOMMANDER_TELEMETRY
+#define STREAMCOMMANDER_TELEMETRY 1
+#endif
+
+// Number of slots of the queue of regular commands, which have been received but not executed yet
+#ifndef STREAMCOMMANDER_COMMAND_QUEUE_SIZE
+#define STREAMCOMMANDER_COMMAND_QUEUE_SIZE 8
+#endif
+
+// Number of asynchronous commands, which can be pending at the same time
+#ifndef STREAMCOMMANDER_MAX_PENDING_COMMANDS
+#define STREAMCOMMANDER_MAX_PENDING_COMMANDS 4
+#endif
+
+// Number of message types, including the 20 standard ones
+#ifndef STREAMCOMMANDER_MAX_MESSAGE_TYPES
+#define STREAMCOMMANDER_MAX_MESSAGE_TYPES 32
+#endif
+
+#if STREAMCOMMANDER_SPLIT_MODE && !STREAMCOMMANDER_QUEUED_TRANSMIT
+#error "The split mode needs STREAMCOMMANDER_QUEUED_TRANSMIT."
+#endif
+
 class StreamCommander
 {
+    // Codecs share our receive buffer and dispatching
+    friend class Codec;
+
+    // The JSON writer shares our number formatting
+    friend class JsonWriter;
+
+public:
+    // Enums
+    // Results of an asynchronous command callback.
+    enum CommandResult
+    {
+        DONE,   // The command has finished.
+        PENDING // The command is still running, and wants to be called again on the next fetchCommand().
+    };
+
+    // What happens to lines which are longer than the maximum line length.
+    enum LineOverflowPolicy
+    {
+        OVERFLOW_DISCARD, // The line gets discarded until the next line ending.
+        OVERFLOW_TRUNCATE // The line gets truncated to the maximum line length, and executed.
+    };
+
+    // IDs of the standard message types, which can be passed to sendMessage() and beginMessage() instead of the type itself.
+    // Custom message types get the IDs returned by addMessageType().
+    enum MessageTypeId
+    {
+        TYPE_RESPONSE,
+        TYPE_INFO,
+        TYPE_ERROR,
+        TYPE_PING,
+        TYPE_STATUS,
+        TYPE_ID,
+        TYPE_ACTIVE,
+        TYPE_ECHO,
+        TYPE_COMMANDS,
+        TYPE_COMMAND,
+        TYPE_TRANSFER,
+        TYPE_CHUNK,
+        TYPE_ACK,
+        TYPE_NAK,
+        TYPE_PENDING,
+        TYPE_DONE,
+        TYPE_CANCELLED,
+        TYPE_SCHEMA,
+        TYPE_MODE,
+        TYPE_TELEMETRY,
+        NUM_STANDARD_MESSAGE_TYPES
+    };
+
+    // Constants
+    static const byte UNREGISTERED_MESSAGE_TYPE = 0xFF; // Message type ID passed to codecs for messages of types which haven't been registered
+
 private:
     // Types
     typedef void (*CommandCallbackFunction)( String arguments, StreamCommander * instance );
+    typedef CommandResult (*AsyncCommandCallbackFunction)( String arguments, StreamCommander * instance );
+    typedef void (*FastCommandCallbackFunction)( StreamCommander * instance );
     typedef void (*DefaultCallbackFunction)( String command, String arguments, StreamCommander * instance );
+    typedef void (*StatusProviderFunction)( StreamCommander * instance );
+    typedef int (*TransferReadFunction)( unsigned long offset, byte * buffer, int length, StreamCommander * instance );
+    typedef int (*TransferWriteFunction)( unsigned long offset, const byte * buffer, int length, StreamCommander * instance );
+
+    // Enums
+    enum TransferDirection
+    {
+        TRANSFER_NONE,
+        TRANSFER_PUSH, // Host -> Device
+        TRANSFER_PULL  // Device -> Host
+    };
+
+    // Content of a message, which decides how codecs encode it
+    enum ContentFormat
+    {
+        CONTENT_TEXT,
+        CONTENT_BINARY,    // Any bytes, see Codec::encodeBinaryMessage()
+        CONTENT_STRUCTURED // MessagePack, see beginStructuredMessage()
+    };
 
     // Structs
+    // Trivially copyable, since the registry gets grown with realloc() and shifted with memmove().
+    // The name gets deleted by removeCommand()/deleteCommands() instead of a destructor, which would never be called on a realloc()ed array anyway.
     struct CommandContainer
     {
         String * command;
+        uint32_t hash;
         CommandCallbackFunction callbackFunction;
+        AsyncCommandCallbackFunction asyncCallbackFunction;
+        unsigned long timeout;
+        bool priority;
+        const char * argumentTypes; // See describeCommand()
+        const char * messageTypes;
+    };
 
-        ~CommandContainer()
+    struct FastCommand
+    {
+        char trigger;
+        FastCommandCallbackFunction callbackFunction;
+    };
+
+    struct QueuedCommand
+    {
+        String command;
+        uint32_t hash;
+        String arguments;
+    };
+
+    // Classes
+    // Print which collects a message, in order to queue it instead of writing it to the stream right away.
+    class MessageBuffer : public Print
+    {
+    public:
+        String content = "";
+
+        size_t write( uint8_t character )
         {
-            // Destroy this pointer, since it is not safe that it will be deleted otherwise.
-            delete command;
+            content += (char) character;
+
+            return 1;
         }
     };
 
+    // Print which appends to a string, in order to encode a message into a slot of the transmit queue.
+    class StringPrint : public Print
+    {
+    public:
+        String & content;
+
+        StringPrint( String & content ) : content( content ) {}
+
+        size_t write( uint8_t character )
+        {
+            content += (char) character;
+
+            return 1;
+        }
+    };
+
+    // Print which only calculates the hash of everything printed to it, in order to hash a schema without rendering it into memory.
+    class HashBuffer : public Print
+    {
+    public:
+        uint32_t hash = COMMAND_HASH_OFFSET;
+
+        size_t write( uint8_t character )
+        {
+            hash = updateCommandHash( hash, character );
+
+            return 1;
+        }
+    };
+
+    struct PendingCommand
+    {
+        AsyncCommandCallbackFunction callbackFunction;
+        String arguments;
+        unsigned int tag;
+        unsigned long startTime;
+        unsigned long timeout;
+    };
+
     // Constants
     static const long STREAM_BUFFER_TIMEOUT  = 100;
     static const char COMMAND_EOL_CR = '\r';
@@ -53,6 +237,57 @@ private:
     static const char MESSAGE_DELIMITER = ':';
     static const int ID_MAX_LENGTH = 32;
     static const String PING_REPLY;
+    static const int TRANSFER_CHUNK_SIZE = 32;
+    static const int MAX_TRANSFER_CHUNK_SIZE = 128;
+    static const int TRANSFER_WINDOW_SIZE = 4;
+    static const int TRANSFER_SEQUENCE_BYTES = 4; // Size of the sequence number in front of binary chunks
+    static const int TRANSFER_CHECKSUM_BYTES = 2; // Size of the checksum behind binary chunks
+    static const int TRANSFER_PUSH_LINE_OVERHEAD = 22; // Length of a "chunk"-line of a push-transfer besides its' hex data: command, sequence (up to 10 digits), checksum and delimiters
+    static const unsigned long TRANSFER_RETRY_TIMEOUT = 1000;
+    static const char TRANSFER_DELIMITER = ' ';
+
+    static const String MESSAGE_TRANSFER;
+    static const String MESSAGE_CHUNK;
+    static const String MESSAGE_ACK;
+    static const String MESSAGE_NAK;
+    static const String MESSAGE_PENDING;
+    static const String MESSAGE_DONE;
+    static const String MESSAGE_CANCELLED;
+    static const String MESSAGE_SCHEMA;
+    static const String MESSAGE_MODE;
+    static const String MESSAGE_TELEMETRY;
+    static const unsigned long MODE_FALLBACK_TIMEOUT = 2000;
+    static const int MAX_CODECS = 4;
+    static const char CODEC_NAME_DELIMITER = ',';
+    static const char SCHEMA_ENTRY_DELIMITER = ';';
+    static const char SCHEMA_FIELD_DELIMITER = ' ';
+    static const char SCHEMA_EMPTY_FIELD = '-';
+    static const char SCHEMA_LIST_DELIMITER = ',';
+    static const char SCHEMA_ID_DELIMITER = '=';
+    static const int MAX_PENDING_COMMANDS = STREAMCOMMANDER_MAX_PENDING_COMMANDS;
+    static const int COMMAND_QUEUE_SIZE = STREAMCOMMANDER_COMMAND_QUEUE_SIZE;
+    static const int PRIORITY_QUEUE_SIZE = 4;
+    static const int TRANSMIT_QUEUE_SIZE = 8;
+    static const int STATUS_SNAPSHOT_LENGTH = 32;
+    static const int STATUS_SNAPSHOT_RETRIES = 8;
+    static const int MAX_FAST_COMMANDS = 4;
+    static const int RECEIVE_CHUNK_SIZE = 32;
+    static const int LINE_BUFFER_SIZE = 128;
+    static const int MAX_MESSAGE_TYPES = STREAMCOMMANDER_MAX_MESSAGE_TYPES;
+    static const int NUMBER_BUFFER_SIZE = 24; // Sign, up to 19 digits, decimal point and terminator
+    static const int MAX_VALUES = 8;
+    static const int VALUES_BUFFER_SIZE = MAX_VALUES * NUMBER_BUFFER_SIZE; // Room for MAX_VALUES numbers of any length, each followed by a delimiter or the terminator
+    static const byte MAX_DECIMALS = 6;
+    static const byte STATUS_TEXT = 0xFF; // Number of decimals of a status, which hasn't been set as a number
+    static const byte STATUS_STRUCTURED = 0xFE; // Number of decimals of a status, which has been set as MessagePack
+    static const byte STATUS_VALUES = 0xFD; // Number of decimals of a status, which has been set as an array of numbers
+    static const char VALUE_DELIMITER = ',';
+    static const byte MAX_TELEMETRY_VALUES = 16;
+    static const int TELEMETRY_BUFFER_SIZE = 2 + MAX_TELEMETRY_VALUES * 5; // Flags, sequence number and a varint of up to 5 bytes per value
+    static const byte TELEMETRY_KEYFRAME = 0x80; // Flag of a telemetry sample which contains the values instead of their differences
+    static const unsigned int TELEMETRY_KEYFRAME_INTERVAL = 16;
+    static const uint32_t COMMAND_HASH_OFFSET = 2166136261UL; // FNV-1a
+    static const uint32_t COMMAND_HASH_PRIME = 16777619UL;
 
     static const String COMMAND_ACTIVATE;
     static const String COMMAND_DEACTIVATE;
@@ -63,10 +298,38 @@ private:
     static const String COMMAND_PING;
     static const String COMMAND_GETSTATUS;
     static const String COMMAND_LISTCOMMANDS;
+    static const String COMMAND_PUSH;
+    static const String COMMAND_PULL;
+    static const String COMMAND_CHUNK;
+    static const String COMMAND_ACK;
+    static const String COMMAND_NAK;
+    static const String COMMAND_ABORT;
+    static const String COMMAND_CANCEL;
+    static const String COMMAND_SCHEMA;
+    static const String COMMAND_SCHEMAHASH;
+    static const String COMMAND_MODE;
+    static const String COMMAND_KEYFRAME;
 
     // Variables
     Stream * streamInstance;
+    SpanTransport * spanTransport = nullptr;
     String status = "";
+    int64_t statusValue = 0; // Fixed-point value of a numeric status, for detecting changes without formatting it
+    byte statusDecimals = STATUS_TEXT;
+    int64_t statusValues[MAX_VALUES]; // Fixed-point values of an array status, for detecting changes without formatting them
+    byte numStatusValues = 0;
+    byte statusValuesDecimals = 0;
+    bool statusHashing = false;
+    uint32_t statusHash = 0; // Hash and length of the last status, which replace the status itself while hashing
+    int statusLength = 0;
+    char * structuredStatus = nullptr; // MessagePack of the last structured status, with its' length in statusLength; no String, since it may contain zero bytes
+    int structuredStatusCapacity = 0;
+    bool statusRequested = false;
+    unsigned long statusRefreshInterval = 0;
+    unsigned long statusSentTime = 0;
+    StatusProviderFunction statusProviderFunction = nullptr;
+    unsigned long statusProviderInterval = 0;
+    unsigned long statusProviderTime = 0;
     bool active;
     bool echoCommands;
     bool addStandardCommands;
@@ -74,9 +337,88 @@ private:
     String id = "";
     char commandDelimiter = COMMAND_DELIMITER;
     char messageDelimiter = MESSAGE_DELIMITER;
+    String messageHeaders[MAX_MESSAGE_TYPES]; // Pre-rendered headers (type + message delimiter) of all registered message types
+    int numMessageTypes = 0;
     CommandContainer * commands;
     DefaultCallbackFunction defaultCallbackFunction;
     int numCommands;
+    String commandList = ""; // Rendered list of all registered commands, which gets rebuilt after the registry has changed
+    bool commandListValid = false;
+    uint32_t schemaHash = 0;
+    bool schemaHashValid = false;
+    TransferReadFunction transferReadFunction = nullptr;
+    TransferWriteFunction transferWriteFunction = nullptr;
+    TransferDirection transferDirection = TRANSFER_NONE;
+    String transferName = "";
+    unsigned long transferSize = 0;
+    unsigned long transferSequence = 0;
+    unsigned long transferAcknowledged = 0;
+    unsigned long transferEndSequence = 0;
+    unsigned long transferLastActivity = 0;
+    bool transferEndReached = false;
+    int transferChunkSize = TRANSFER_CHUNK_SIZE;
+    int transferActiveChunkSize = TRANSFER_CHUNK_SIZE; // Chunk size of the current transfer, which is smaller for push-transfers if their lines wouldn't fit otherwise
+    int transferWindowSize = TRANSFER_WINDOW_SIZE;
+    #if STREAMCOMMANDER_TELEMETRY
+    int32_t telemetryValues[MAX_TELEMETRY_VALUES]; // Previous sample, which the next one gets delta-encoded against
+    byte numTelemetryValues = 0;
+    byte telemetrySequence = 0;
+    unsigned int telemetrySamples = 0; // Samples since the last keyframe, including it
+    unsigned int telemetryKeyframeInterval = TELEMETRY_KEYFRAME_INTERVAL;
+    bool telemetryKeyframeRequested = true;
+    unsigned int telemetryDroppedMessages = 0;
+    #endif
+    FastCommand fastCommands[MAX_FAST_COMMANDS];
+    volatile int numFastCommands = 0;
+    char lineBuffer[LINE_BUFFER_SIZE + 1];
+    int lineLength = 0;
+    int maxLineLength = LINE_BUFFER_SIZE;
+    bool lineOverflow = false;
+    LineOverflowPolicy lineOverflowPolicy = OVERFLOW_DISCARD;
+    volatile byte numOverflowedLines = 0;
+    byte numReportedOverflowedLines = 0;
+    int lineCommandEnd = -1;
+    uint32_t lineCommandHash = COMMAND_HASH_OFFSET;
+    TextCodec textCodec;
+    BinaryCodec binaryCodec;
+    MessagePackCodec messagePackCodec;
+    Codec * codecs[MAX_CODECS] = { &textCodec, &binaryCodec, &messagePackCodec };
+    int numCodecs = 3;
+    Codec * volatile codec = &textCodec;
+    Codec * receiveCodec = &textCodec; // Codec the current receive state belongs to; only used by the receiving side
+    bool codecConfirmed = true; // Set by the receiving side, and read by the dispatching side, see setCodecConfirmed()
+    unsigned long codecTime = 0;
+    unsigned long modeFallbackTimeout = MODE_FALLBACK_TIMEOUT;
+    byte messageTypeId = 0; // Type of the message which is currently collected in messageBuffer
+    String messageHeader = ""; // Header of the message which is currently collected, if its' type hasn't been registered
+    Codec * messageCodec = nullptr; // Codec which streams the current message, or nullptr if it gets collected in messageBuffer
+    SpscQueue<QueuedCommand, COMMAND_QUEUE_SIZE> commandQueue;
+    QueuedCommand heldCommand; // Regular command which has arrived while the command queue was full; only used by the receiving side
+    volatile bool commandHeld = false;
+    #if STREAMCOMMANDER_SPLIT_MODE
+    bool splitMode = false;
+    SpscQueue<QueuedCommand, PRIORITY_QUEUE_SIZE> priorityQueue;
+    #endif
+    #if STREAMCOMMANDER_QUEUED_TRANSMIT
+    bool queuedTransmit = false;
+    MpscQueue<String, TRANSMIT_QUEUE_SIZE> transmitQueue;
+    #endif
+    MessageBuffer messageBuffer;
+    MessageBuffer statusBuffer; // Collects a structured status, see beginStructuredStatus()
+    MessagePackWriter messageWriter = MessagePackWriter( messageBuffer );
+    MessagePackWriter statusWriter = MessagePackWriter( statusBuffer );
+    JsonWriter messageJsonWriter = JsonWriter( messageBuffer );
+    JsonWriter statusJsonWriter = JsonWriter( statusBuffer );
+    ContentFormat messageFormat = CONTENT_TEXT;
+    byte numReportedDroppedCommands = 0;
+    volatile char statusSnapshot[STATUS_SNAPSHOT_LENGTH + 1];
+    volatile byte statusSnapshotSequence = 0;
+    byte statusSnapshotReadSequence = 0;
+    PendingCommand pendingCommands[MAX_PENDING_COMMANDS];
+    int numPendingCommands = 0;
+    unsigned int nextRequestTag = 1; // Tags start at 1, so 0 never refers to a request
+    unsigned int requestTag = 0;
+    bool cancelling = false;
 
     // Private Methods
     // Sets the streamInstance of the StreamCommander.
@@ -100,11 +442,20 @@ private:
     void loadIdFromEeprom();
     #endif
 
-    // Gets the container containing all commands.
-    CommandContainer * getCommandContainer( String command );
+    // Gets the container of a specific command by name and its' hash (see hashCommand()).
+    CommandContainer * getCommandContainer( String command, uint32_t hash );
+
+    // Returns the index (position) of a specific command in the command container by name and its' hash (see hashCommand()).
+    int getCommandContainerIndex( String command, uint32_t hash );
+
+    // Calculates the hash of a command name, which is used to look up commands without comparing the whole names.
+    static uint32_t hashCommand( String command );
 
-    // Returns the index (position) of a specific command in the command container by name.
-    int getCommandContainerIndex( String command );
+    // Adds a single character to the hash of a command name (FNV-1a), so the hash can also be calculated while the name is being received.
+    static uint32_t updateCommandHash( uint32_t hash, char character );
+
+    // Registers a command with either a synchronous or an asynchronous callback.
+    void registerCommand( String command, CommandCallbackFunction commandCallback, AsyncCommandCallbackFunction asyncCommandCallback, unsigned long timeout, bool priority );
 
     // Deletes all registered commands.
     void deleteCommands();
@@ -112,11 +463,188 @@ private:
     // Sets the number of the currently registered commands.
     void setNumCommands( int numCommands );
 
+    // Marks everything which has been rendered from the registered commands as outdated.
+    void invalidateCommandList();
+
+    // Prints the entries of the schema (without its' hash), see getSchemaHash().
+    void printSchema( Print & output );
+
+    // Prints a field of a schema entry, or SCHEMA_EMPTY_FIELD if it's empty.
+    static void printSchemaField( Print & output, const char * field );
+
+    // Prints the message types of a schema entry, each followed by its' ID if it has been registered, or SCHEMA_EMPTY_FIELD if there are none.
+    void printSchemaMessageTypes( Print & output, const char * messageTypes );
+
     // Increments the number of the currently registered commands.
     void incrementNumCommands();
 
-    // Tries to execute a command with given arguments. Arguments can be empty.
-    void executeCommand( String command, String arguments );
+    // Tries to execute a command (with the hash of its' name) with given arguments. Arguments can be empty.
+    void executeCommand( String command, String arguments, uint32_t hash );
+
+    // Calls an asynchronous command callback for the first time, and keeps it pending if it hasn't finished yet.
+    void startAsyncCommand( String command, String arguments, AsyncCommandCallbackFunction callbackFunction, unsigned long timeout );
+
+    // Calls all pending asynchronous command callbacks once, and removes the ones which have finished or exceeded their timeout.
+    void processPendingCommands();
+
+    // Calls a pending command one last time with isCancelled() set, so it can clean up, and removes it.
+    void stopPendingCommand( int index );
+
+    // Removes a pending command, keeping the order of the remaining ones.
+    void removePendingCommand( int index );
+
+    // Splits a complete line (without its' line ending) into command and arguments at the position of the first command delimiter (or -1 if there is none), and dispatches it.
+    // The hash of the command name has already been calculated while the line was being received.
+    void parseCommand( char * line, int length, int commandEnd, uint32_t hash );
+
+    // Appends characters to the line buffer, as far as the maximum line length allows. Returns the number of appended characters.
+    int appendToLine( const char * data, int length );
+
+    // Invokes the fast command with the given trigger byte. Returns false if there is none.
+    bool matchFastCommand( char character );
+
+    // Resets the state of a partially received line.
+    void resetReceiveState();
+
+    // Queues the regular command, which has been held back because the command queue was full, as soon as there is room again.
+    void queueHeldCommand();
+
+    // Feeds received bytes into the line-based receive state machine, which is used by the text codec.
+    void receiveTextBytes( const char * data, int length );
+
+    // Looks up a command by its' ID (see the schema), and dispatches it with the line buffer as arguments. Used by binary codecs.
+    void dispatchCommandId( byte commandId );
+
+    // Switches the codec. Unconfirmed switches fall back to the text codec, if no valid command arrives within the fallback timeout.
+    void switchCodec( Codec * codec, bool confirmed );
+
+    // Falls back to the text codec, if an unconfirmed switch to another codec has timed out.
+    void processCodecFallback();
+
+    // Sets/gets whether the current codec has been confirmed. In split mode, both sides access the flag.
+    void setCodecConfirmed( bool codecConfirmed );
+    bool isCodecConfirmed();
+
+    // Gets a registered codec by its' name, or nullptr if there is none.
+    Codec * getCodecByName( String name );
+
+    // Gets the names of all registered codecs, separated by CODEC_NAME_DELIMITER.
+    String getCodecNames();
+
+    // Encodes a message with the current codec, and writes it to the stream or the transmit queue.
+    void sendEncodedMessage( byte messageTypeId, const String & header, const char * content, int length, ContentFormat format = CONTENT_TEXT );
+
+    // Encodes a message with the given codec, according to the format of its' content.
+    static void encodeMessage( Codec * codec, Print & output, byte messageTypeId, const String & header, const char * content, int length, ContentFormat format );
+
+    // Returns the position of the first byte in data which equals one of the stop bytes, or length if there is none.
+    // On 32/64 bit architectures, whole words get checked at once (SWAR), so runs of regular characters are skipped quickly.
+    static int findStopByte( const char * data, int length, const char * stopBytes, int numStopBytes );
+
+    // Executes priority commands right away (or queues them in the priority queue in split mode), and appends all other commands to the command queue.
+    void queueCommand( String command, String arguments, uint32_t hash );
+
+    // Appends a command to one of the queues. Returns false if the queue is full.
+    template <unsigned int SIZE>
+    bool pushCommand( SpscQueue<QueuedCommand, SIZE> & queue, String command, String arguments, uint32_t hash );
+
+    // Removes the oldest command from one of the queues and executes it. Returns false if the queue is empty.
+    template <unsigned int SIZE>
+    bool executeQueuedCommand( SpscQueue<QueuedCommand, SIZE> & queue );
+
+    // Executes all commands of the priority queue, and the oldest command of the command queue.
+    void processQueuedCommands();
+
+    // Registers the standard message types, unless this has already happened.
+    void addStandardMessageTypes();
+
+    // Renders the header of a message type into the header cache. Returns the ID of the message type, or -1 if the cache is full.
+    int insertMessageType( const String & type );
+
+    // Gets the ID of a registered message type (its' index in the header cache), or -1 if it hasn't been registered.
+    int getMessageTypeIndex( const String & type );
+
+    // Sends a message with the type of the given ID, and content which has already been formatted (or encoded) into a buffer.
+    void sendMessage( byte messageTypeId, const char * content, int length, ContentFormat format = CONTENT_TEXT );
+
+    // Starts a message with an already rendered header, see beginMessage().
+    Print & beginMessageWithHeader( byte messageTypeId, const String & header );
+
+
+    // Formats a fixed-point number (value / 10^decimals) into the buffer, which has to hold NUMBER_BUFFER_SIZE characters. Returns the length.
+    static int formatNumber( char * buffer, int64_t value, byte decimals );
+
+    // Converts a floating-point number into a fixed-point number with the given decimals. Returns false if it's out of range or not a number.
+    static bool scaleNumber( double value, byte decimals, int64_t & scaledValue );
+
+    // Formats a floating-point number with the given decimals into the buffer, which has to hold NUMBER_BUFFER_SIZE characters. Returns the length.
+    // Numbers which are too large for a fixed-point number get written in scientific notation (e.g. 1.00e30), and non-finite ones as nan, inf or -inf.
+    static int formatNumber( char * buffer, double value, byte decimals );
+
+    // Formats an array of up to MAX_VALUES numbers, separated by VALUE_DELIMITER, into the buffer, which has to hold VALUES_BUFFER_SIZE characters. Returns the length.
+    static int formatValues( char * buffer, const int * values, byte numValues );
+    static int formatValues( char * buffer, const int64_t * values, byte numValues, byte decimals );
+    static int formatValues( char * buffer, const float * values, byte numValues, byte decimals );
+
+    // Sends an error and returns false, if an array has more than MAX_VALUES numbers.
+    bool checkNumValues( byte numValues );
+
+    // Updates the status with a fixed-point number (value / 10^decimals); detects changes by comparing the numbers instead of their text.
+    void updateNumericStatus( int64_t value, byte decimals );
+
+    // Updates the status with an array of fixed-point numbers; detects changes by comparing the numbers instead of their text.
+    void updateValuesStatus( const int64_t * values, byte numValues, byte decimals );
+
+    // Updates the status with text which has already been formatted into a buffer.
+    void updateTextStatus( const char * status, int length );
+
+    // Sends the status, which has already been formatted into a buffer, if we're active (or it has been requested).
+    void sendUpdatedStatus( const char * status, int length, ContentFormat format = CONTENT_TEXT );
+
+    // Returns whether the status has to be sent by the next update, even if it hasn't changed (because it has been requested, or is due for a refresh).
+    bool isStatusDue();
+
+    // Calculates the hash of a status (FNV-1a, like the command hashes).
+    static uint32_t hashStatus( const char * status, int length );
+
+    #if STREAMCOMMANDER_TELEMETRY
+    // Writes a signed value as zigzag varint (0, -1, 1, -2, ... become 0, 1, 2, 3, ..., 7 bits per byte). Returns the number of written bytes.
+    static int encodeZigzagVarint( char * buffer, int32_t value );
+    #endif
+
+    // Takes over a status which has been published with publishStatus() since the last call, and updates the status with it.
+    // If no consistent copy could be taken within STATUS_SNAPSHOT_RETRIES attempts, the status stays as it is until the next call.
+    void processStatusSnapshot();
+
+    // Calls the status provider, if we're active and it's due according to its' interval.
+    void processStatusProvider();
+
+    // Prevents the compiler and CPU from reordering memory accesses across this point.
+    static void memoryBarrier();
+
+    // Starts a new transfer in the given direction, and resets the state of a possibly running one.
+    void startTransfer( TransferDirection direction, String name, unsigned long size );
+
+    // Ends the current transfer.
+    void stopTransfer();
+
+    // Sends the chunks of a running pull-transfer as far as the window allows, and retransmits unacknowledged ones after a timeout.
+    void processTransfer();
+
+    // Reads a chunk at the given sequence number via the read callback and sends it. Returns the number of bytes sent, or -1 on failure.
+    int sendChunk( unsigned long sequence );
+
+    // Receives a chunk of a push-transfer ("<sequence> <hex-data> <checksum>") and passes it to the write callback.
+    void receiveChunk( String arguments );
+
+    // Calculates the CRC-16/CCITT checksum of a chunk.
+    static uint16_t calculateChecksum( const byte * data, int length );
+
+    // Converts a hex character to its' value, or returns -1 if it's not a valid hex character.
+    static int hexToNibble( char character );
+
+    // Prints a value as a fixed amount of hex digits.
+    static void printHex( Print & output, unsigned long value, int digits );
 
     // Definition of the command COMMAND_ACTIVATE.
     static void commandActivate( String arguments, StreamCommander * instance );
@@ -145,6 +673,44 @@ private:
     // Definition of the command COMMAND_LISTCOMMANDS.
     static void commandListCommands( String arguments, StreamCommander * instance );
 
+    // Definition of the command COMMAND_SCHEMA.
+    static void commandSchema( String arguments, StreamCommander * instance );
+
+    // Definition of the command COMMAND_SCHEMAHASH.
+    static void commandSchemaHash( String arguments, StreamCommander * instance );
+
+    // Definition of the command COMMAND_MODE.
+    static void commandMode( String mode, StreamCommander * instance );
+
+    #if STREAMCOMMANDER_TELEMETRY
+    // Definition of the command COMMAND_KEYFRAME.
+    static void commandKeyframe( String arguments, StreamCommander * instance );
+    #endif
+
+    // Definition of the command COMMAND_CANCEL.
+    static void commandCancel( String tag, StreamCommander * instance );
+
+    // Returns whether a text is a non-empty, unsigned decimal number.
+    static bool isUnsignedNumber( const String & text );
+
+    // Definition of the command COMMAND_PUSH.
+    static void commandPush( String arguments, StreamCommander * instance );
+
+    // Definition of the command COMMAND_PULL.
+    static void commandPull( String arguments, StreamCommander * instance );
+
+    // Definition of the command COMMAND_CHUNK.
+    static void commandChunk( String arguments, StreamCommander * instance );
+
+    // Definition of the command COMMAND_ACK.
+    static void commandAck( String arguments, StreamCommander * instance );
+
+    // Definition of the command COMMAND_NAK.
+    static void commandNak( String arguments, StreamCommander * instance );
+
+    // Definition of the command COMMAND_ABORT.
+    static void commandAbort( String arguments, StreamCommander * instance );
+
     // Registers all the above commands.
     void addAllStandardCommands();
 
@@ -199,6 +765,14 @@ public:
     // Gets the message delimiter.
     char getMessageDelimiter();
 
+    // Registers a custom message type, so its' header (type + message delimiter) gets rendered once instead of on every message.
+    // The standard message types are always registered. Returns the ID of the message type, or -1 if no more types can be registered.
+    // Message types should be registered up front, before messages get sent from several tasks.
+    int addMessageType( String type );
+
+    // Gets the number of registered message types.
+    int getNumMessageTypes();
+
     // Sets whether all incoming commands should be echoed or not (true/false).
     void setEchoCommands( bool echoCommands );
 
@@ -221,36 +795,315 @@ public:
     // Update the status of the StreamCommander/Device; updates the status and sends an automatic status message only if the status changed.
     void updateStatus( String status );
 
+    // Numeric variants of updateStatus(), which don't construct a String: changes are detected by comparing the numbers,
+    // and only a changed status gets formatted (straight into the sent message) by a fast integer-to-ASCII routine.
+    void updateStatus( int value );
+    void updateStatus( unsigned int value );
+    void updateStatus( long value );
+    void updateStatus( unsigned long value );
+
+    // Floating-point numbers are compared and sent with a fixed number of decimals (up to MAX_DECIMALS).
+    void updateStatus( double value, byte decimals = 2 );
+
+    // Small arrays (up to MAX_VALUES numbers) get sent as a list of values separated by commas. Larger ones get rejected with an error.
+    void updateStatus( const int * values, byte numValues );
+    void updateStatus( const float * values, byte numValues, byte decimals = 2 );
+
+    // Publishes a new status from an interrupt (e.g. a timer ISR), where updateStatus() must not be called.
+    // The status gets copied into a fixed buffer (up to STATUS_SNAPSHOT_LENGTH characters), protected by a sequence lock instead of disabling interrupts.
+    // The next fetchCommand()/dispatchCommands() takes it over and calls updateStatus() with it, which detects changes and sends the status.
+    // Only one publisher is allowed, and it must not be preemptible by the reading side: an interrupt, or a task with a higher priority than the one calling dispatchCommands().
+    // A publisher which gets preempted halfway would keep the reader from ever getting a consistent copy, so the reader gives up after a few attempts and retries on its' next call.
+    void publishStatus( const char * status );
+
+    // Starts a structured status, which gets written as MessagePack through the returned writer (see beginStructuredMessage()).
+    // It gets applied by endStructuredStatus(), which (like updateStatus()) only sends it if it has changed.
+    MessagePackWriter & beginStructuredStatus();
+
+    // Applies a structured status, which has been started with beginStructuredStatus().
+    void endStructuredStatus();
+
+    // Starts a JSON status, which gets written through the returned writer into a buffer (kept between updates, so it doesn't get reallocated).
+    // It gets applied by endJsonStatus(), which (like updateStatus()) only sends it if it has changed.
+    JsonWriter & beginJsonStatus();
+
+    // Applies a JSON status, which has been started with beginJsonStatus().
+    void endJsonStatus();
+
     // Sets the current status StreamCommander/Device.
     void setStatus( String status );
 
-    // Gets the current status StreamCommander/Device.
+    // Gets the current status StreamCommander/Device (structured statuses as MessagePack, which may contain zero bytes). While hashing, only numeric statuses can be returned (otherwise it's empty).
     String getStatus();
 
+    // Sets whether changes of the status get detected by a 32 bit hash (and the length) of the last status instead of a copy of it (true/false).
+    // This saves keeping a second copy of large statuses, and comparing them byte by byte on every update.
+    // As the status itself isn't kept, a status requested with the getstatus-command gets sent by the next updateStatus().
+    // A hash collision would hide a change; setStatusRefreshInterval() makes sure such a status still gets sent eventually.
+    void setStatusHashing( bool statusHashing );
+
+    // Returns whether changes of the status get detected by a hash.
+    bool isStatusHashing();
+
+    // Sets the interval (in ms) after which updateStatus() sends the status again, even if it hasn't changed (0 = never, the default).
+    void setStatusRefreshInterval( unsigned long statusRefreshInterval );
+
+    // Gets the interval after which updateStatus() sends the status again.
+    unsigned long getStatusRefreshInterval();
+
+    // Sets a callback which provides the status on demand, by calling updateStatus() itself (or nullptr to remove it).
+    // Instead of formatting a status on every loop, the status only gets formatted when it's actually needed:
+    // It gets called on the getstatus-command, and while we're active every interval (in ms, 0 = on every fetchCommand()/dispatchCommands()).
+    // While we aren't active, it doesn't get called by the schedule at all.
+    void setStatusProvider( StatusProviderFunction statusProviderFunction, unsigned long interval = 0 );
+
+    // Gets the callback which provides the status on demand.
+    StatusProviderFunction getStatusProvider();
+
     // Registers a new command; a command name tied to a command callback.
     void addCommand( String command, CommandCallbackFunction commandCallback );
 
+    // Registers a new priority command; a command name tied to a command callback.
+    // Priority commands get executed as soon as their line has been received, instead of waiting in the command queue behind other commands.
+    // This bounds the latency of urgent commands (e.g. an emergency stop), no matter how many other commands are queued.
+    void addPriorityCommand( String command, CommandCallbackFunction commandCallback );
+
+    // Gets the number of received commands which are waiting to be executed.
+    int getNumQueuedCommands();
+
+    // Gets the number of commands which have been dropped, because the command queue was full. It wraps around at 256, so only the difference between two calls is meaningful.
+    byte getNumDroppedCommands();
+
+    // Registers a new asynchronous command; a command name tied to a callback which returns PENDING until it has finished.
+    // Pending commands get called again on every fetchCommand(), so other commands keep being served meanwhile.
+    // Optionally, a timeout (in ms) can be set, after which a pending command gets cancelled and an error is sent.
+    void addAsyncCommand( String command, AsyncCommandCallbackFunction commandCallback, unsigned long timeout = 0 );
+
+    // Cancels the pending asynchronous command with the given tag. Returns false if no such command is pending.
+    bool cancelCommand( unsigned int tag );
+
+    // Returns whether the current call of an asynchronous command callback is its' last one, because it has been cancelled or timed out.
+    // The callback should then release its' resources (e.g. stop a motor); its' return value is ignored.
+    bool isCancelled();
+
+    // Gets the tag of the asynchronous command which is currently being executed, in order to mark its' responses.
+    unsigned int getRequestTag();
+
+    // Gets the number of currently pending asynchronous commands.
+    int getNumPendingCommands();
+
     // Gets the number of the registered commands.
     int getNumCommands();
 
+    // Unregisters a command. Like adding commands, this shouldn't happen while receiving and dispatching run on different cores/tasks.
+    void removeCommand( String command );
+
     // Gets a list of all registered commands.
+    // The list gets rendered once and cached, until the registered commands change.
     String getCommandList();
 
+    // Describes a registered command for the schema (see sendSchema()), so hosts know how to call it without guessing.
+    // The argument types are given as one character per argument: 'i' integer, 'f' floating-point number, 'w' word (without spaces),
+    // 'x' hex data and 't' text (the rest of the line). The message types the command answers with are separated by commas, e.g. "response,error".
+    // Both are kept as pointers, so they should be string literals.
+    void describeCommand( String command, const char * argumentTypes, const char * messageTypes );
+
+    // Gets the hash of the schema (FNV-1a of its' entries), which only changes if the registered commands or their descriptions change.
+    // It gets calculated once and cached, without rendering the schema into memory.
+    uint32_t getSchemaHash();
+
     // Sets the default callback which gets called in case a sent command is not registered.
     void setDefaultCallback( DefaultCallbackFunction defaultCallbackFunction );
 
     // Gets the default callback.
     DefaultCallbackFunction getDefaultCallback();
 
+    // Registers a new fast command; a single trigger byte tied to a minimal callback.
+    // Fast commands are recognized by receiveByte() as soon as the trigger byte arrives (anywhere within a line), and their callback is invoked right there,
+    // without buffering, parsing or queueing. Thus, the trigger byte should not occur in regular commands (e.g. a control character), and the callback should be as short as possible.
+    // The MessagePack codec only recognizes them between two commands, and the binary codec not at all, since every byte between two frames belongs to a length.
+    void addFastCommand( char trigger, FastCommandCallbackFunction commandCallback );
+
+    // Feeds a single received byte into the StreamCommander: matches fast commands, assembles lines, and dispatches completed commands.
+    // fetchCommand() does this for all available bytes of the stream. Instead, it can also be called from a receive routine (e.g. serialEvent()), so fast commands fire without waiting for the next loop().
+    // It must be the only feeder of bytes then: call dispatchCommands() instead of fetchCommand(). The receive state isn't protected against concurrent access, so it must not be called in interrupt context.
+    void receiveByte( char character );
+
+    // Sets the maximum length of a line (up to LINE_BUFFER_SIZE characters, without line ending).
+    // Lines are assembled in a fixed buffer, so no matter what gets received, the memory used for receiving stays the same.
+    void setMaxLineLength( int maxLineLength );
+
+    // Gets the maximum length of a line.
+    int getMaxLineLength();
+
+    // Sets what happens to lines which are longer than the maximum line length (OVERFLOW_DISCARD or OVERFLOW_TRUNCATE).
+    // In both cases, an error gets sent which contains the number of affected lines.
+    void setLineOverflowPolicy( LineOverflowPolicy lineOverflowPolicy );
+
+    // Gets what happens to lines which are longer than the maximum line length.
+    LineOverflowPolicy getLineOverflowPolicy();
+
+    // Feeds several received bytes into the StreamCommander, see receiveByte().
+    // Line endings, the first command delimiter of a line and fast command triggers are all found within a single pass over the bytes.
+    void receiveBytes( const char * data, int length );
+
     // Fetches and interprets incoming commands, and invokes the corresponding callbacks. This should be called in the loop or after an interrupt/event.
+    // Priority commands get executed right away; other commands are queued, and one of them gets executed per call.
+    // Also keeps pending asynchronous commands and a running pull-transfer going.
+    // This is the same as calling receiveCommands() and dispatchCommands().
     void fetchCommand();
 
+    // Receiving half of fetchCommand(): Writes queued messages to the stream, reads all available bytes and queues the received commands.
+    // The available bytes are read in chunks with readBytes(), or scanned in place if a span transport has been set.
+    // Reading goes on while the command queue is full, so priority and fast commands don't wait behind regular ones. Regular commands which don't fit anymore get dropped and reported.
+    void receiveCommands();
+
+    // Sets a transport, which hands over received bytes as contiguous spans (or nullptr to read from the stream again).
+    // The stream is still used for sending messages.
+    void setSpanTransport( SpanTransport * spanTransport );
+
+    // Gets the span transport, or nullptr if the bytes are read from the stream.
+    SpanTransport * getSpanTransport();
+
+    // Sets the codec, in which commands are received and messages are sent (or nullptr for the text codec). The command registry and callbacks stay the same.
+    // Hosts can also negotiate the codec with the mode-command; a switch away from the text codec then gets confirmed by the first valid command.
+    void setCodec( Codec * codec );
+
+    // Gets the codec, in which commands are received and messages are sent.
+    Codec * getCodec();
+
+    // Registers a custom codec, so hosts can select it with the mode-command by its' name.
+    // The text, binary and MessagePack codecs are always registered.
+    void addCodec( Codec * codec );
+
+    // Sets the time (in ms) after which a negotiated switch away from the text codec falls back to it, if no valid command has arrived.
+    void setModeFallbackTimeout( unsigned long modeFallbackTimeout );
+
+    // Gets the time after which a negotiated switch away from the text codec falls back to it.
+    unsigned long getModeFallbackTimeout();
+
+    // Dispatching half of fetchCommand(): Executes queued commands and keeps pending asynchronous commands and transfers going.
+    void dispatchCommands();
+
+    // Sets whether receiving and dispatching are split (true/false), so they can run on different cores or tasks:
+    // receiveCommands() is then called by one core/task (which owns the stream), and dispatchCommands() by the other one.
+    // Both sides are linked by lock-free queues: received commands (including priority commands) get queued for the dispatching side,
+    // and messages get queued for the receiving side (see setQueuedTransmit()), which writes them to the stream.
+    // All commands should be registered before both sides start running. Not available if STREAMCOMMANDER_SPLIT_MODE is 0.
+    void setSplitMode( bool splitMode );
+
+    // Returns whether receiving and dispatching are split.
+    bool isSplitMode();
+
+    // Sets whether messages get queued instead of being written to the stream right away (true/false). This is always the case in split mode.
+    // Messages can then be sent from any number of tasks/cores at the same time: each message gets rendered into its' own slot of a lock-free queue,
+    // so lines never interleave and senders never wait for the stream. The queue gets written to the stream by transmitMessages().
+    // Messages streamed with beginMessage() may only be sent by the task calling fetchCommand()/dispatchCommands() though. Not available if STREAMCOMMANDER_QUEUED_TRANSMIT is 0.
+    void setQueuedTransmit( bool queuedTransmit );
+
+    // Returns whether messages get queued instead of being written to the stream right away.
+    bool isQueuedTransmit();
+
+    // Writes all queued messages to the stream. This is the only place where queued messages get written, and gets called by receiveCommands().
+    void transmitMessages();
+
+    // Gets the number of messages which have been dropped, because the transmit queue was full.
+    unsigned int getNumDroppedMessages();
+
+    #if STREAMCOMMANDER_TELEMETRY
+    // Sends a sample of numeric telemetry (up to MAX_TELEMETRY_VALUES 32 bit values, e.g. sensor readings as fixed-point numbers) as compact binary message:
+    // <flags | number of values><sequence number><values>, each value as zigzag varint. Values get sent as their difference to the previous sample,
+    // except in keyframes (flag TELEMETRY_KEYFRAME), which contain the values themselves, so hosts can resync after lost messages.
+    // Binary codecs send a sample of small changes in a few bytes; the text codec sends the message as hex digits, which takes twice the bytes plus the message type,
+    // so the gain there is small, and keyframes may even take more than the values as text. Samples should only be sent by one task.
+    void sendTelemetry( const int32_t * values, byte numValues );
+
+    // Sets after how many samples a keyframe gets sent (0 or 1 = every sample).
+    // Keyframes also get sent if the number of values changes, after messages have been dropped, and on request (see requestTelemetryKeyframe()).
+    void setTelemetryKeyframeInterval( unsigned int telemetryKeyframeInterval );
+
+    // Gets after how many samples a keyframe gets sent.
+    unsigned int getTelemetryKeyframeInterval();
+
+    // Makes the next telemetry sample a keyframe. Hosts can request this with the keyframe-command, e.g. after a gap in the sequence numbers.
+    void requestTelemetryKeyframe();
+    #endif
+
+    // Sets the callbacks which provide the data of pull-transfers, and take the data of push-transfers.
+    // The callbacks get called with the byte offset within the transfer, and return the number of bytes read/written (or < 0 on failure).
+    void setTransferCallbacks( TransferReadFunction transferReadFunction, TransferWriteFunction transferWriteFunction );
+
+    // Returns whether a transfer is currently running.
+    bool isTransferring();
+
+    // Gets the name of the current transfer, as requested by the host.
+    String getTransferName();
+
+    // Aborts the current transfer.
+    void abortTransfer();
+
+    // Sets the maximum number of bytes per chunk (up to MAX_TRANSFER_CHUNK_SIZE), for transfers which get started afterwards.
+    // Chunks of push-transfers have to fit into the maximum line length, including their hex encoding, so push-transfers announce a smaller chunk size if necessary
+    // (e.g. 53 bytes with the default maximum line length of 128).
+    void setTransferChunkSize( int transferChunkSize );
+
+    // Gets the maximum number of bytes per chunk.
+    int getTransferChunkSize();
+
+    // Sets how many chunks may be unacknowledged at once, for transfers which get started afterwards.
+    void setTransferWindowSize( int transferWindowSize );
+
+    // Gets how many chunks may be unacknowledged at once.
+    int getTransferWindowSize();
+
     // Sends a message with a specific type and content separated by our delimiter.
+    // Registered message types are sent with their cached header, all others get their header rendered on the fly.
     void sendMessage( String type, String content );
 
+    // Sends a message with the type of the given ID (see MessageTypeId and addMessageType()) and content separated by our delimiter.
+    // The cached header gets written right away, without constructing or comparing the type.
+    void sendMessage( byte messageTypeId, String content );
+
+    // Starts a message with a specific type by sending the type and our delimiter.
+    // The content can then be streamed piece by piece through the returned Print, until the message gets terminated with endMessage().
+    Print & beginMessage( String type );
+
+    // Starts a message with the type of the given ID, see beginMessage().
+    Print & beginMessage( byte messageTypeId );
+
+    // Starts a message of type MessageType::RESPONSE, see beginMessage().
+    Print & beginResponse();
+
+    // Starts a structured message with the type of the given ID, whose content gets written as MessagePack through the returned writer,
+    // straight into the transmit buffer, until the message gets terminated with endMessage(). Hosts can decode it without parsing any text:
+    // The text codec sends the content as hex digits, the binary codec as it is, and the MessagePack codec embeds it as object.
+    MessagePackWriter & beginStructuredMessage( byte messageTypeId );
+
+    // Starts a structured message of type MessageType::RESPONSE, see beginStructuredMessage().
+    MessagePackWriter & beginStructuredResponse();
+
+    // Starts a message with the type of the given ID, whose content gets written as JSON through the returned writer,
+    // straight to the stream (or into the transmit buffer), until the message gets terminated with endMessage().
+    JsonWriter & beginJsonMessage( byte messageTypeId );
+
+    // Starts a JSON message of type MessageType::RESPONSE, see beginJsonMessage().
+    JsonWriter & beginJsonResponse();
+
+    // Terminates a message which has been started with beginMessage(), beginStructuredMessage() or beginJsonMessage().
+    void endMessage();
+
     // Sends a message of type MessageType::RESPONSE.
     void sendResponse( String response );
 
+    // Numeric variants of sendResponse(), which format the number straight into the message instead of constructing a String.
+    void sendResponse( int value );
+    void sendResponse( unsigned int value );
+    void sendResponse( long value );
+    void sendResponse( unsigned long value );
+    void sendResponse( double value, byte decimals = 2 );
+    void sendResponse( const int * values, byte numValues );
+    void sendResponse( const float * values, byte numValues, byte decimals = 2 );
+
     // Sends a message of type MessageType::INFO.
     void sendInfo( String info );
 
@@ -274,6 +1127,13 @@ public:
 
     // Sends a message of type MessageType::COMMANDS, contains a list of currently registered commands.
     void sendCommands();
+
+    // Sends a message of type MESSAGE_SCHEMA, contains the schema hash, followed by an entry per registered command:
+    // <hash>;<id> <name> <argument types> <message types>;... (with '-' for missing descriptions). The ID of a command is its' index in the registry.
+    void sendSchema();
+
+    // Sends a message of type MESSAGE_SCHEMA, contains only the schema hash. Hosts which already know a schema with this hash can skip the discovery.
+    void sendSchemaHash();
 };
 
 #endif // STREAMCOMMANDER_HPP
\ No newline at end of file